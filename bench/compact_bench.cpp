@@ -0,0 +1,165 @@
+// Memory footprint and lazy view cost of the compact game representation.
+//
+//   ./compact_bench [positions]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compact.hpp"
+#include "compact_gamestate.hpp"
+#include "gamestate.hpp"
+#include "utils.hpp"
+
+using namespace fogchess;
+
+namespace
+{
+    const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    std::vector<move_t> legal_moves(const real_board_t& board, bool is_white)
+    {
+        std::vector<move_t> moves;
+        for (int cell_id = 0; cell_id < 64; ++cell_id) {
+            piece_t piece = board.board[cell_id];
+            if (piece != EMPTY && (piece & (is_white ? WHITE : BLACK))) {
+                for (auto move : get_move(board, {cell_id})) {
+                    if (is_valid_move_for(board, is_white, move))
+                        moves.push_back(move);
+                }
+            }
+        }
+        return moves;
+    }
+
+    // Plays the same random game on both representations
+    void random_game(std::mt19937& rng, int plies, GameState& eager, CompactGameState& compact, std::vector<move_t>& played)
+    {
+        for (int ply = 0; ply < plies && !eager.has_winner(); ++ply) {
+            auto moves = legal_moves(eager.get_board(), eager.is_white_turn());
+            if (moves.empty())
+                break;
+            move_t move = moves[rng() % moves.size()];
+            eager.make_move(move);
+            compact.make_move(move);
+            played.push_back(move);
+        }
+    }
+
+    bool same_board(const player_board_t& a, const player_board_t& b)
+    {
+        return a.board == b.board;
+    }
+
+    template <typename F>
+    double ns_per_op(std::size_t ops, F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t positions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    std::mt19937 rng(404);
+
+    std::cout << "--- bytes per game ---\n";
+    std::cout << "GameState          " << sizeof(GameState) << "\n";
+    std::cout << "CompactGameState   " << sizeof(CompactGameState) << "\n";
+    std::cout << "  real_board_t     " << sizeof(real_board_t) << " -> compact_board_t " << sizeof(compact_board_t) << "\n";
+    std::cout << "  player_board_t   " << sizeof(player_board_t) << " x2 -> derived on demand\n";
+    std::cout << "  move_t           " << sizeof(move_t) << " -> packed_move_t " << sizeof(packed_move_t) << "\n";
+    std::cout << "  castling_info_t  " << sizeof(castling_info_t) << " -> 1\n";
+
+    std::vector<GameState> eager_games;
+    std::vector<CompactGameState> compact_games;
+    std::vector<std::vector<move_t>> game_moves(positions);
+    std::size_t move_count = 0;
+    eager_games.reserve(positions);
+    compact_games.reserve(positions);
+
+    for (std::size_t i = 0; i < positions; ++i) {
+        eager_games.emplace_back(START_FEN);
+        compact_games.emplace_back(START_FEN);
+        random_game(rng, 1 + rng() % 60, eager_games.back(), compact_games.back(), game_moves[i]);
+        move_count += game_moves[i].size();
+    }
+
+    // Both representations must agree before their speed means anything
+    for (std::size_t i = 0; i < positions; ++i) {
+        const auto& e = eager_games[i];
+        const auto& c = compact_games[i];
+        if (!same_board(e.get_white_player(), c.get_white_player())
+            || !same_board(e.get_black_player(), c.get_black_player())
+            || e.is_white_turn() != c.is_white_turn()
+            || e.get_winner_raw() != c.get_winner_raw()) {
+            std::cerr << "Mismatch between GameState and CompactGameState at game " << i << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "\n--- view materialization, " << positions << " positions ---\n";
+    uint64_t sink = 0;
+
+    double eager_view = ns_per_op(positions, [&] {
+        for (const auto& game : eager_games) {
+            player_board_t view = game.get_white_player();
+            sink += view.board[0];
+        }
+    });
+    double unpack = ns_per_op(positions, [&] {
+        for (const auto& game : compact_games) {
+            real_board_t board = game.get_board();
+            sink += board.board[0];
+        }
+    });
+    double mask = ns_per_op(positions, [&] {
+        for (const auto& game : compact_games)
+            sink += visibility_mask(game.get_board(), true);
+    });
+    double lazy_view = ns_per_op(positions, [&] {
+        for (const auto& game : compact_games) {
+            player_board_t view = game.get_white_player();
+            sink += view.board[0];
+        }
+    });
+
+    std::cout << "eager copy (GameState)     " << eager_view << " ns\n";
+    std::cout << "unpack real board          " << unpack << " ns\n";
+    std::cout << "unpack + visibility mask   " << mask << " ns\n";
+    std::cout << "lazy view (Compact)        " << lazy_view << " ns\n";
+
+    // Each recorded game is replayed on its own fresh state, built before the
+    // clock starts so only the (always legal) moves are timed
+    std::cout << "\n--- make_move, " << move_count << " moves ---\n";
+    std::size_t moves_played = 0;
+    std::vector<GameState> eager_replays(positions, GameState(START_FEN));
+    double eager_move = ns_per_op(move_count, [&] {
+        for (std::size_t i = 0; i < positions; ++i) {
+            for (const auto& move : game_moves[i])
+                moves_played += eager_replays[i].make_move(move);
+        }
+    });
+    std::vector<CompactGameState> compact_replays(positions, CompactGameState(START_FEN));
+    double compact_move = ns_per_op(move_count, [&] {
+        for (std::size_t i = 0; i < positions; ++i) {
+            for (const auto& move : game_moves[i])
+                moves_played += compact_replays[i].make_move(move);
+        }
+    });
+
+    std::cout << "GameState                  " << eager_move << " ns\n";
+    std::cout << "CompactGameState           " << compact_move << " ns\n";
+
+    if (moves_played != 2 * move_count) {
+        std::cerr << "Replayed " << moves_played << " of " << 2 * move_count << " moves\n";
+        return EXIT_FAILURE;
+    }
+    return sink + moves_played == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
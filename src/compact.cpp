@@ -0,0 +1,116 @@
+#include "compact.hpp"
+
+namespace fogchess
+{
+    namespace
+    {
+        const uint8_t BLACK_BIT = 0b1000;
+
+        // Indexed by nibble, unpacking a board is just table lookups
+        const piece_t NIBBLE_TO_PIECE[16] = {
+            EMPTY,
+            static_cast<piece_t>(PAWN | WHITE), static_cast<piece_t>(KNIGHT | WHITE),
+            static_cast<piece_t>(BISHOP | WHITE), static_cast<piece_t>(ROOK | WHITE),
+            static_cast<piece_t>(QUEEN | WHITE), static_cast<piece_t>(KING | WHITE),
+            EMPTY, EMPTY,
+            static_cast<piece_t>(PAWN | BLACK), static_cast<piece_t>(KNIGHT | BLACK),
+            static_cast<piece_t>(BISHOP | BLACK), static_cast<piece_t>(ROOK | BLACK),
+            static_cast<piece_t>(QUEEN | BLACK), static_cast<piece_t>(KING | BLACK),
+            EMPTY,
+        };
+    }
+
+    uint8_t pack_piece(piece_t piece)
+    {
+        uint8_t kind;
+        switch (piece & 0x1f) {
+        case PAWN:   kind = 1; break;
+        case KNIGHT: kind = 2; break;
+        case BISHOP: kind = 3; break;
+        case ROOK:   kind = 4; break;
+        case QUEEN:  kind = 5; break;
+        case KING:   kind = 6; break;
+        default:     return 0;
+        }
+        return (piece & BLACK) ? (kind | BLACK_BIT) : kind;
+    }
+
+    piece_t unpack_piece(uint8_t nibble)
+    {
+        return NIBBLE_TO_PIECE[nibble & 0x0f];
+    }
+
+    packed_move_t pack_move(const move_t& move)
+    {
+        if (move.start_cell.cell_id < 0 || move.end_cell.cell_id < 0)
+            return NO_MOVE;
+        return static_cast<packed_move_t>(move.start_cell.cell_id | (move.end_cell.cell_id << 6));
+    }
+
+    move_t unpack_move(packed_move_t move)
+    {
+        if (move == NO_MOVE)
+            return {{-1}, {-1}};
+        return {{move & 0x3f}, {(move >> 6) & 0x3f}};
+    }
+
+    uint8_t pack_castling(const castling_info_t& info)
+    {
+        return (info.white_king_moved ? 1 << 0 : 0)
+             | (info.white_kingside_rook_moved ? 1 << 1 : 0)
+             | (info.white_queenside_rook_moved ? 1 << 2 : 0)
+             | (info.black_king_moved ? 1 << 3 : 0)
+             | (info.black_kingside_rook_moved ? 1 << 4 : 0)
+             | (info.black_queenside_rook_moved ? 1 << 5 : 0);
+    }
+
+    castling_info_t unpack_castling(uint8_t bits)
+    {
+        castling_info_t info;
+        info.white_king_moved = (bits >> 0) & 1;
+        info.white_kingside_rook_moved = (bits >> 1) & 1;
+        info.white_queenside_rook_moved = (bits >> 2) & 1;
+        info.black_king_moved = (bits >> 3) & 1;
+        info.black_kingside_rook_moved = (bits >> 4) & 1;
+        info.black_queenside_rook_moved = (bits >> 5) & 1;
+        return info;
+    }
+
+    piece_t get_piece_at_cell(const compact_board_t& board, int cell_id)
+    {
+        uint8_t byte = board.cells[cell_id >> 1];
+        return unpack_piece((cell_id & 1) ? (byte >> 4) : (byte & 0x0f));
+    }
+
+    void set_piece_at_cell(compact_board_t& board, int cell_id, piece_t piece)
+    {
+        uint8_t& byte = board.cells[cell_id >> 1];
+        uint8_t nibble = pack_piece(piece);
+        if (cell_id & 1)
+            byte = (byte & 0x0f) | (nibble << 4);
+        else
+            byte = (byte & 0xf0) | nibble;
+    }
+
+    compact_board_t pack_board(const real_board_t& board)
+    {
+        compact_board_t compact;
+        for (int i = 0; i < 32; ++i)
+            compact.cells[i] = pack_piece(board.board[2 * i]) | (pack_piece(board.board[2 * i + 1]) << 4);
+        compact.last_move = pack_move(board.last_move);
+        compact.castling = pack_castling(board.info);
+        return compact;
+    }
+
+    real_board_t unpack_board(const compact_board_t& board)
+    {
+        real_board_t real;
+        for (int i = 0; i < 32; ++i) {
+            real.board[2 * i] = NIBBLE_TO_PIECE[board.cells[i] & 0x0f];
+            real.board[2 * i + 1] = NIBBLE_TO_PIECE[board.cells[i] >> 4];
+        }
+        real.last_move = unpack_move(board.last_move);
+        real.info = unpack_castling(board.castling);
+        return real;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+#include "common.hpp"
+
+namespace fogchess
+{
+    // from | to << 6, NO_MOVE when there is none
+    using packed_move_t = uint16_t;
+    const packed_move_t NO_MOVE = 0xffff;
+
+    // Real board squeezed into 36 bytes: one nibble per square
+    // (bit 3 = black, bits 0-2 = piece kind) and one bit per castling flag.
+    struct compact_board_t {
+        std::array<uint8_t, 32> cells;
+        packed_move_t last_move;
+        uint8_t castling;
+    };
+
+    uint8_t pack_piece(piece_t piece);
+    piece_t unpack_piece(uint8_t nibble);
+
+    packed_move_t pack_move(const move_t& move);
+    move_t unpack_move(packed_move_t move);
+
+    uint8_t pack_castling(const castling_info_t& info);
+    castling_info_t unpack_castling(uint8_t bits);
+
+    piece_t get_piece_at_cell(const compact_board_t& board, int cell_id);
+    void set_piece_at_cell(compact_board_t& board, int cell_id, piece_t piece);
+
+    compact_board_t pack_board(const real_board_t& board);
+    real_board_t unpack_board(const compact_board_t& board);
+}
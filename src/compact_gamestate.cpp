@@ -0,0 +1,76 @@
+#include "compact_gamestate.hpp"
+
+#include "utils.hpp"
+
+namespace fogchess
+{
+    CompactGameState::CompactGameState(const std::string& fen)
+    {
+        board = pack_board(board_from_fen(fen));
+        state = 1;
+    }
+
+    CompactGameState::CompactGameState(const real_board_t& board, bool is_white_turn)
+    {
+        this->board = pack_board(board);
+        state = is_white_turn ? 1 : 0;
+    }
+
+    bool CompactGameState::is_valid_move(const move_t& move) const
+    {
+        return is_valid_move_for(unpack_board(board), is_white_turn(), move);
+    }
+
+    bool CompactGameState::make_move(const move_t& move)
+    {
+        real_board_t real = unpack_board(board);
+        if (!is_valid_move_for(real, is_white_turn(), move))
+            return false;
+
+        auto captured_piece = apply_move(real, move);
+        board = pack_board(real);
+
+        state ^= 1;
+
+        if (captured_piece & KING)
+            declare_winner(!(captured_piece & WHITE));
+
+        return true;
+    }
+
+    void CompactGameState::declare_winner(bool is_white_winner)
+    {
+        if (has_winner())
+            return;
+        state |= is_white_winner ? 0b010 : 0b100;
+    }
+
+    bool CompactGameState::has_winner() const
+    {
+        return (state & 0b110) != 0;
+    }
+
+    uint8_t CompactGameState::get_winner_raw() const
+    {
+        if (state & 0b010)
+            return 1;
+        if (state & 0b100)
+            return 0xff;
+        return 0;
+    }
+
+    player_board_t CompactGameState::get_white_player() const
+    {
+        return board_for_player(unpack_board(board), true);
+    }
+
+    player_board_t CompactGameState::get_black_player() const
+    {
+        return board_for_player(unpack_board(board), false);
+    }
+
+    uint64_t CompactGameState::get_visibility_mask(bool is_player_white) const
+    {
+        return visibility_mask(unpack_board(board), is_player_white);
+    }
+}
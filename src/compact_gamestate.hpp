@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "compact.hpp"
+
+namespace fogchess
+{
+    // Drop-in alternative to GameState for holding many mostly idle games.
+    // Only the packed real board is stored, player views are rebuilt from
+    // visibility masks whenever they are asked for.
+    class CompactGameState
+    {
+    private:
+        compact_board_t board;
+        // bit 0: white to move, bits 1-2: winner (1 = white, 2 = black)
+        uint8_t state;
+
+    public:
+        CompactGameState(const std::string& fen);
+        CompactGameState(const real_board_t& board, bool is_white_turn);
+
+        bool make_move(const move_t& move);
+        void declare_winner(bool is_white_winner);
+        bool has_winner() const;
+
+        real_board_t get_board() const { return unpack_board(board); }
+        player_board_t get_white_player() const;
+        player_board_t get_black_player() const;
+        // Recomputed on every call, unlike GameState
+        uint64_t get_visibility_mask(bool is_player_white) const;
+        bool is_white_turn() const { return state & 1; }
+        // Same encoding as GameState: 1 for white, 0xff for black
+        uint8_t get_winner_raw() const;
+
+        bool is_valid_move(const move_t& move) const;
+    };
+}
@@ -1,140 +1,104 @@
 
 
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <string>
-#include <algorithm>
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
+#include <thread>
 #include <unistd.h>
-#include <fcntl.h>
-#include "common.hpp"
-#include "serializer.hpp"
-#include "utils.hpp"
-#include "gamestate.hpp"
+#include "live_table.hpp"
+#include "lobby.hpp"
+#include "logger.hpp"
+#include "router.hpp"
+#include "session.hpp"
+#include "timing_wheel.hpp"
 
 
 using namespace fogchess;
 
-int main() {
-  // --- Socket setup ---
-  int server_fd1, server_fd2, client_fd1, client_fd2;
-  struct sockaddr_in address1, address2;
-  int opt = 1;
-  socklen_t addrlen = sizeof(sockaddr_in);
-
-  server_fd1 = socket(AF_INET, SOCK_STREAM, 0);
-  server_fd2 = socket(AF_INET, SOCK_STREAM, 0);
-  if (server_fd1 < 0 || server_fd2 < 0) { perror("socket"); exit(EXIT_FAILURE); }
-  setsockopt(server_fd1, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
-  setsockopt(server_fd2, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
-
-  address1.sin_family = AF_INET;
-  address1.sin_addr.s_addr = INADDR_ANY;
-  address1.sin_port = htons(8001);
-  address2.sin_family = AF_INET;
-  address2.sin_addr.s_addr = INADDR_ANY;
-  address2.sin_port = htons(8002);
-
-  if (bind(server_fd1, (struct sockaddr *)&address1, sizeof(address1)) < 0) { perror("bind 8001"); exit(EXIT_FAILURE); }
-  if (bind(server_fd2, (struct sockaddr *)&address2, sizeof(address2)) < 0) { perror("bind 8002"); exit(EXIT_FAILURE); }
-
-  if (listen(server_fd1, 1) < 0) { perror("listen 8001"); exit(EXIT_FAILURE); }
-  if (listen(server_fd2, 1) < 0) { perror("listen 8002"); exit(EXIT_FAILURE); }
-
-  std::cout << "Waiting for White (port 8001) and Black (port 8002) to connect...\n";
-  client_fd1 = accept(server_fd1, (struct sockaddr *)&address1, &addrlen);
-  if (client_fd1 < 0) { perror("accept 8001"); exit(EXIT_FAILURE); }
-  std::cout << "White connected!\n";
-  client_fd2 = accept(server_fd2, (struct sockaddr *)&address2, &addrlen);
-  if (client_fd2 < 0) { perror("accept 8002"); exit(EXIT_FAILURE); }
-  std::cout << "Black connected!\n";
-
-  // Initialize GameState
-  std::string start_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-  GameState game(start_fen);
+// Every game is played at this time control: {initial, increment, delay} in ms.
+static const session_config_t session = {{5 * 60 * 1000, 3 * 1000, 0}, std::chrono::minutes(2)};
+
+// Slots in the shared-memory table of live games read by fogchess-live
+static const uint32_t live_table_slots = 16384;
+
+static std::string self_path(const char* argv0) {
+  char buf[4096];
+  ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+  if (n <= 0)
+    return argv0;
+  buf[n] = '\0';
+  return buf;
+}
+
+static int run_single_process(const lobby_config_t& config) {
+  // A single wheel drives the clocks of every game on the server
+  static TimingWheel wheel(std::chrono::milliseconds(10));
+  wheel.start();
+
+  // Every pair gets its own game thread, games block on their players' sockets.
+  // Past session.max_games new pairs are turned away.
+  static std::atomic<uint64_t> next_game_id{1};
+
+  Lobby lobby(config, [](const pairing_t& pairing) {
+    start_game_thread(pairing.white_fd, pairing.black_fd, session, [pairing]() {
+      game_snapshot_t snapshot{};
+      snapshot.game_id = next_game_id++;
+      play_game(pairing.white_fd, pairing.black_fd, session, wheel, snapshot);
+    });
+  });
+
+  if (!lobby.start()) {
+    std::cerr << "Failed to start the lobby on port " << config.port << "\n";
+    return EXIT_FAILURE;
+  }
+
+  while (true)
+    pause();
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+  // A player dropping mid-game must not take the whole server down
+  std::signal(SIGPIPE, SIG_IGN);
+
+  // Re-executed by the router: serve games handed over on the given socket
+  if (argc == 3 && std::strcmp(argv[1], "--worker") == 0) {
+    Logger::global().start(logger_config_from_env(), std::cout);
+    if (!LiveTable::global().open(LIVE_TABLE_NAME, true))
+      std::cerr << "Live game table unavailable, monitoring disabled\n";
+    int status = run_worker(std::atoi(argv[2]), session);
+    Logger::global().stop();
+    return status;
+  }
+
+  std::size_t worker_count = 0;
+  if (argc == 3 && std::strcmp(argv[1], "--workers") == 0)
+    worker_count = std::strtoul(argv[2], nullptr, 10);
+
+  lobby_config_t config;
+  config.port = 8001;
+  config.acceptor_count = std::max(1u, std::thread::hardware_concurrency() / 2);
 
   std::cout << "Fog of War Chess (C++ prototype)\n";
   std::cout << "Rules: No check; capture the king to win. Promotions auto-queen. Castling/en passant TODO.\n";
+  std::cout << "Lobby listening on port " << config.port << ", players are paired as they connect...\n";
 
-  while (true) {
-    print_real_board(game.get_board(), std::cout);
-
-    bool is_player_white = game.is_white_turn();
-    int client_fd = is_player_white ? client_fd1 : client_fd2;
-
-    // Get player's board view
-    player_board_t player_board = is_player_white ? game.get_white_player() : game.get_black_player();
-    std::string serialized = serialize_board(player_board);
-
-    std::string prompt = (is_player_white ? "White" : "Black") + std::string(" to move\n") + serialized + "\nEnter move (e.g., e2e4) or 'q': ";
-    send(client_fd, prompt.c_str(), prompt.size(), 0);
-
-    // --- Socket input ---
-    char buf[16] = {0};
-    ssize_t n = recv(client_fd, buf, sizeof(buf)-1, 0);
-    if (n <= 0) {
-      std::cout << "Connection closed or error.\n";
-      break;
-    }
-    std::string s(buf);
-    s.erase(std::remove(s.begin(), s.end(), '\n'), s.end());
-    s.erase(std::remove(s.begin(), s.end(), '\r'), s.end());
-    if (s == "q" || s == "quit")
-      break;
-    if (s.size() != 4) {
-      std::string msg = "Format: e2e4\n";
-      std::cout << msg;
-      send(client_fd, msg.c_str(), msg.size(), 0);
-      continue;
-    }
-
-    // Convert input to move_t
-    std::string from_str = s.substr(0, 2);
-    std::string to_str = s.substr(2, 2);
-    std::pair<uint8_t, uint8_t> from_rf = {from_str[1] - '1', from_str[0] - 'a'};
-    std::pair<uint8_t, uint8_t> to_rf = {to_str[1] - '1', to_str[0] - 'a'};
-    if (!is_valid(from_rf) || !is_valid(to_rf)) {
-      std::string msg = "Bad squares\n";
-      std::cout << msg;
-      send(client_fd, msg.c_str(), msg.size(), 0);
-      continue;
-    }
-    cell_t from_cell{static_cast<int>(from_rf.first * 8 + from_rf.second)};
-    cell_t to_cell{static_cast<int>(to_rf.first * 8 + to_rf.second)};
-    move_t move{from_cell, to_cell};
-
-    // Validate move legality using GameState
-    if (!game.is_valid_move(move)) {
-      std::string msg = "Illegal move\n";
-      std::cout << msg;
-      send(client_fd, msg.c_str(), msg.size(), 0);
-      continue;
-    }
-
-    // Apply move
-    game.make_move(move);
-
-    // After move, send updated board to both players
-    for (int i = 0; i < 2; ++i) {
-      bool is_player_white = (i == 0);
-      int client_fd = is_player_white ? client_fd1 : client_fd2;
-      player_board_t player_board = is_player_white ? game.get_white_player() : game.get_black_player();
-      std::string serialized = serialize_board(player_board);
-      std::string prompt = (is_player_white ? "White" : "Black") + std::string(" to move\n") + serialized + "\nEnter move (e.g., e2e4) or 'q': ";
-      send(client_fd, prompt.c_str(), prompt.size(), 0);
-    }
-
-    // Check for winner
-    if (game.has_winner()) {
-      std::string msg = "Game over! Winner: ";
-      msg += (game.get_winner_raw() == 1 ? "White" : "Black");
-      msg += "\n";
-      std::cout << msg;
-      send(client_fd1, msg.c_str(), msg.size(), 0);
-      send(client_fd2, msg.c_str(), msg.size(), 0);
-      break;
-    }
+  // Created before any worker starts, workers only join it
+  if (!LiveTable::global().create(LIVE_TABLE_NAME, live_table_slots))
+    std::cerr << "Live game table unavailable, monitoring disabled\n";
+
+  if (worker_count == 0) {
+    // Games only push records, formatting and writing happen on the logger thread
+    Logger::global().start(logger_config_from_env(), std::cout);
+    return run_single_process(config);
   }
-  return 0;
+
+  Router router(self_path(argv[0]), config);
+  return router.run(worker_count);
 }
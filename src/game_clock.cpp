@@ -0,0 +1,52 @@
+#include "game_clock.hpp"
+
+#include <algorithm>
+
+namespace fogchess
+{
+    GameClock::GameClock(const time_control_t& control)
+        : control(control), white_running(true), turn_started()
+    {
+        remaining_ms[0] = control.initial_ms;
+        remaining_ms[1] = control.initial_ms;
+    }
+
+    int64_t GameClock::charged_ms(time_point now) const
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - turn_started).count();
+        return std::max<int64_t>(0, elapsed - control.delay_ms);
+    }
+
+    void GameClock::start_turn(bool is_white, time_point now)
+    {
+        white_running = is_white;
+        turn_started = now;
+    }
+
+    bool GameClock::end_turn(time_point now)
+    {
+        int64_t& remaining = remaining_ms[white_running ? 0 : 1];
+        remaining -= charged_ms(now);
+        if (remaining <= 0) {
+            remaining = 0;
+            return false;
+        }
+
+        remaining += control.increment_ms;
+        return true;
+    }
+
+    void GameClock::suspend(time_point now)
+    {
+        int64_t& remaining = remaining_ms[white_running ? 0 : 1];
+        remaining = std::max<int64_t>(0, remaining - charged_ms(now));
+        turn_started = now;
+    }
+
+    std::chrono::milliseconds GameClock::time_left(time_point now) const
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - turn_started).count();
+        int64_t left = remaining(white_running) + control.delay_ms - elapsed;
+        return std::chrono::milliseconds(std::max<int64_t>(0, left));
+    }
+}
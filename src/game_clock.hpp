@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace fogchess
+{
+    struct time_control_t {
+        uint32_t initial_ms;
+        uint32_t increment_ms;  // added after every completed move
+        uint32_t delay_ms;      // grace period at the start of each move before the clock runs
+    };
+
+    // Chess clock for both sides. Pure bookkeeping, the caller decides when a
+    // turn starts and ends and arms a timer for time_left() to catch flag-falls.
+    class GameClock
+    {
+    public:
+        using time_point = std::chrono::steady_clock::time_point;
+
+    private:
+        time_control_t control;
+        int64_t remaining_ms[2];
+        bool white_running;
+        time_point turn_started;
+
+        int64_t charged_ms(time_point now) const;
+
+    public:
+        GameClock(const time_control_t& control);
+
+        void start_turn(bool is_white, time_point now);
+        // Charges the running side and adds the increment; false if it flagged.
+        bool end_turn(time_point now);
+        // Charges the running side without an increment, used to hand a game over mid-turn.
+        void suspend(time_point now);
+        void set_remaining(bool is_white, int64_t ms) { remaining_ms[is_white ? 0 : 1] = ms; }
+
+        // Time until the running side flags, including any unused delay.
+        std::chrono::milliseconds time_left(time_point now) const;
+        int64_t remaining(bool is_white) const { return remaining_ms[is_white ? 0 : 1]; }
+        const time_control_t& get_control() const { return control; }
+    };
+}
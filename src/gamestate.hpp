@@ -12,15 +12,23 @@ namespace fogchess
         real_board_t board;
         player_board_t white_player;
         player_board_t black_player;
+        // What each side sees, kept so monitoring does not redo the work
+        uint64_t white_visible;
+        uint64_t black_visible;
 
         uint8_t winner;
 
         bool is_player_white_turn;
 
+        void update_player_boards();
+
     public:
         GameState(const std::string& fen);
+        GameState(const real_board_t& board, bool is_white_turn);
 
         bool make_move(const move_t& move);
+        // Ends the game, used for king captures as well as flag-falls and forfeits
+        void declare_winner(bool is_white_winner);
         bool has_winner() const;
         int get_winner() const;
 
@@ -28,6 +36,7 @@ namespace fogchess
         const real_board_t& get_board() const { return board; }
         const player_board_t& get_white_player() const { return white_player; }
         const player_board_t& get_black_player() const { return black_player; }
+        uint64_t get_visibility_mask(bool is_player_white) const { return is_player_white ? white_visible : black_visible; }
         bool is_white_turn() const { return is_player_white_turn; }
         uint8_t get_winner_raw() const { return winner; }
 
@@ -0,0 +1,47 @@
+#include "hash_ring.hpp"
+
+namespace fogchess
+{
+    // splitmix64 finalizer, cheap and well mixed for sequential IDs
+    uint64_t hash64(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    HashRing::HashRing(int virtual_nodes)
+        : virtual_nodes(virtual_nodes)
+    {
+    }
+
+    void HashRing::add_worker(int worker_id)
+    {
+        // Seeded by the worker so its points never line up with hash64(game_id)
+        uint64_t seed = hash64(~uint64_t(worker_id));
+        for (int i = 0; i < virtual_nodes; ++i)
+            ring[hash64(seed + i)] = worker_id;
+    }
+
+    void HashRing::remove_worker(int worker_id)
+    {
+        for (auto it = ring.begin(); it != ring.end();) {
+            if (it->second == worker_id)
+                it = ring.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    int HashRing::worker_for(uint64_t game_id) const
+    {
+        if (ring.empty())
+            return -1;
+
+        auto it = ring.lower_bound(hash64(game_id));
+        if (it == ring.end())
+            it = ring.begin();
+        return it->second;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace fogchess
+{
+    // Consistent hash ring mapping game IDs to worker IDs. Adding or removing
+    // a worker only moves the games that hash next to its virtual nodes.
+    class HashRing
+    {
+    private:
+        std::map<uint64_t, int> ring;
+        int virtual_nodes;
+
+    public:
+        explicit HashRing(int virtual_nodes = 64);
+
+        void add_worker(int worker_id);
+        void remove_worker(int worker_id);
+        bool empty() const { return ring.empty(); }
+
+        // Returns -1 when there are no workers
+        int worker_for(uint64_t game_id) const;
+    };
+
+    uint64_t hash64(uint64_t x);
+}
@@ -0,0 +1,83 @@
+#include "ipc.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fogchess
+{
+    namespace
+    {
+        const int MAX_FDS = 2;
+    }
+
+    bool send_message(int sock, const router_message_t& message, const int* fds, int fd_count)
+    {
+        iovec iov{const_cast<router_message_t*>(&message), sizeof(message)};
+
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+        if (fd_count > 0) {
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(sizeof(int) * fd_count);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+            std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fd_count);
+        }
+
+        ssize_t n;
+        do {
+            n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+
+        return n == static_cast<ssize_t>(sizeof(message));
+    }
+
+    bool recv_message(int sock, router_message_t& message, int* fds, int& fd_count)
+    {
+        iovec iov{&message, sizeof(message)};
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS)];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n;
+        do {
+            n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+        } while (n < 0 && errno == EINTR);
+
+        fd_count = 0;
+        if (n <= 0)
+            return false;
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                int count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                std::memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * std::min(count, MAX_FDS));
+                fd_count = std::min(count, MAX_FDS);
+            }
+        }
+
+        // Short or truncated message: the kernel already closed the fds that
+        // did not fit, the ones that arrived are useless without the rest
+        if ((msg.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) || n != static_cast<ssize_t>(sizeof(message))) {
+            for (int i = 0; i < fd_count; ++i)
+                close(fds[i]);
+            fd_count = 0;
+            return false;
+        }
+
+        return true;
+    }
+}
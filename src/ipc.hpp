@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#include "session.hpp"
+
+namespace fogchess
+{
+    enum router_message_type_t : uint8_t {
+        START_GAME = 1,     // router -> worker, carries both client sockets
+        MIGRATE_GAME,       // router -> worker, suspend one game and hand it back
+        DRAIN,              // router -> worker, hand every game back
+        GAME_EXPORTED,      // worker -> router, carries both client sockets
+        GAME_ENDED,         // worker -> router
+    };
+
+    struct router_message_t {
+        router_message_type_t type;
+        game_snapshot_t snapshot;
+    };
+
+    // One message per SOCK_SEQPACKET datagram, client sockets ride along as
+    // SCM_RIGHTS so the receiving process owns its own copies.
+    bool send_message(int sock, const router_message_t& message, const int* fds = nullptr, int fd_count = 0);
+    // Returns false on EOF, error or a truncated message. At most 2 fds are
+    // received, any fds that did arrive are closed when it returns false.
+    bool recv_message(int sock, router_message_t& message, int* fds, int& fd_count);
+}
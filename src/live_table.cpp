@@ -0,0 +1,207 @@
+#include "live_table.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hash_ring.hpp"
+
+namespace fogchess
+{
+    namespace
+    {
+        bool is_process_alive(int32_t pid)
+        {
+            return kill(pid, 0) == 0 || errno != ESRCH;
+        }
+    }
+
+    LiveTable::LiveTable()
+        : header(nullptr), slots(nullptr), mapped_size(0), pid(getpid())
+    {
+    }
+
+    LiveTable::~LiveTable()
+    {
+        close();
+    }
+
+    LiveTable& LiveTable::global()
+    {
+        static LiveTable table;
+        return table;
+    }
+
+    bool LiveTable::map(int fd, std::size_t size, bool is_writable)
+    {
+        int prot = is_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* memory = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED) {
+            perror("mmap");
+            return false;
+        }
+
+        header = static_cast<live_table_header_t*>(memory);
+        slots = reinterpret_cast<live_game_t*>(header + 1);
+        mapped_size = size;
+        pid = getpid();
+        return true;
+    }
+
+    bool LiveTable::create(const std::string& name, uint32_t capacity)
+    {
+        close();
+        shm_unlink(name.c_str());
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            perror("shm_open");
+            return false;
+        }
+
+        std::size_t size = sizeof(live_table_header_t) + sizeof(live_game_t) * capacity;
+        if (ftruncate(fd, size) < 0) {
+            perror("ftruncate");
+            ::close(fd);
+            return false;
+        }
+
+        // ftruncate zero-fills, so every slot starts free with sequence 0
+        bool is_mapped = map(fd, size, true);
+        ::close(fd);
+        if (!is_mapped)
+            return false;
+
+        header->capacity = capacity;
+        header->slot_size = sizeof(live_game_t);
+        header->version = LIVE_TABLE_VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = LIVE_TABLE_MAGIC;
+        return true;
+    }
+
+    bool LiveTable::open(const std::string& name, bool is_writable)
+    {
+        close();
+
+        int fd = shm_open(name.c_str(), is_writable ? O_RDWR : O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(live_table_header_t))) {
+            ::close(fd);
+            return false;
+        }
+
+        bool is_mapped = map(fd, st.st_size, is_writable);
+        ::close(fd);
+        if (!is_mapped)
+            return false;
+
+        std::size_t expected = sizeof(live_table_header_t) + sizeof(live_game_t) * header->capacity;
+        if (header->magic != LIVE_TABLE_MAGIC || header->version != LIVE_TABLE_VERSION
+            || header->slot_size != sizeof(live_game_t) || expected > mapped_size) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void LiveTable::close()
+    {
+        if (header)
+            munmap(header, mapped_size);
+        header = nullptr;
+        slots = nullptr;
+        mapped_size = 0;
+    }
+
+    live_game_t* LiveTable::claim(uint64_t game_id)
+    {
+        if (!header)
+            return nullptr;
+
+        // Probe from the game's hash so claims spread over the table
+        uint32_t capacity = header->capacity;
+        uint32_t start = static_cast<uint32_t>(hash64(game_id) % capacity);
+
+        for (uint32_t i = 0; i < capacity; ++i) {
+            live_game_t& slot = slots[(start + i) % capacity];
+            int32_t owner = slot.owner_pid.load(std::memory_order_relaxed);
+
+            // Our own slots are live by definition, no need for a syscall
+            if (owner != 0 && (owner == pid || is_process_alive(owner)))
+                continue;
+            if (!slot.owner_pid.compare_exchange_strong(owner, pid, std::memory_order_acquire))
+                continue;
+
+            // A previous owner may have died mid-publish, leaving the sequence odd
+            uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+            if (sequence & 1)
+                slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+
+            live_game_state_t state{};
+            state.game_id = game_id;
+            state.last_move = NO_MOVE;
+            publish(&slot, state);
+            return &slot;
+        }
+        return nullptr;
+    }
+
+    void LiveTable::release(live_game_t* slot)
+    {
+        if (!slot)
+            return;
+        slot->owner_pid.store(0, std::memory_order_release);
+    }
+
+    void LiveTable::publish(live_game_t* slot, const live_game_state_t& state)
+    {
+        if (!slot)
+            return;
+
+        uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+        slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(&slot->state, &state, sizeof(state));
+
+        slot->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    bool LiveTable::read(uint32_t index, live_game_state_t& state, int32_t& owner_pid) const
+    {
+        if (!header || index >= header->capacity)
+            return false;
+
+        const live_game_t& slot = slots[index];
+        for (;;) {
+            owner_pid = slot.owner_pid.load(std::memory_order_acquire);
+            if (owner_pid == 0)
+                return false;
+
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                // Stays odd forever if the writer died mid-publish
+                if (!is_process_alive(owner_pid))
+                    return false;
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::memcpy(&state, &slot.state, sizeof(state));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+    }
+}
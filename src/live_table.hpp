@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+#include "compact.hpp"
+
+namespace fogchess
+{
+    const char* const LIVE_TABLE_NAME = "/fogchess-live";
+    const uint32_t LIVE_TABLE_MAGIC = 0x46434c54;   // "FCLT"
+    const uint32_t LIVE_TABLE_VERSION = 1;
+
+    // What monitoring sees of a game, copied in and out of the table as a whole
+    struct live_game_state_t {
+        uint64_t game_id;
+        compact_board_t board;
+        uint64_t white_visible;     // bit per cell, same layout as cell_id
+        uint64_t black_visible;
+        int64_t clock_ms[2];        // white, black; 0 for untimed games
+        uint32_t move_count;
+        uint32_t last_move_latency_us;  // input received to both boards sent
+        packed_move_t last_move;
+        uint8_t is_white_turn;
+        uint8_t winner;             // 0 running, 1 white, 2 black
+    };
+
+    // One slot per live game. Only the game that claimed it writes, readers
+    // retry until they see the same even sequence before and after a copy.
+    struct alignas(64) live_game_t {
+        std::atomic<uint32_t> sequence;
+        std::atomic<int32_t> owner_pid;     // 0 when free
+        live_game_state_t state;
+    };
+
+    struct alignas(64) live_table_header_t {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t slot_size;
+    };
+
+    // Fixed size table of live games in POSIX shared memory. The server side
+    // never locks or makes a syscall to publish, other processes on the host
+    // map the same table read-only to watch every game.
+    class LiveTable
+    {
+    private:
+        live_table_header_t* header;
+        live_game_t* slots;
+        std::size_t mapped_size;
+        int32_t pid;
+
+        bool map(int fd, std::size_t size, bool is_writable);
+
+    public:
+        LiveTable();
+        ~LiveTable();
+
+        LiveTable(const LiveTable&) = delete;
+        LiveTable& operator=(const LiveTable&) = delete;
+
+        static LiveTable& global();
+
+        // Server side: replaces any previous table of that name
+        bool create(const std::string& name, uint32_t capacity);
+        // Joins a table created by another process, read-only for monitors
+        bool open(const std::string& name, bool is_writable);
+        void close();
+
+        bool is_open() const { return header != nullptr; }
+        uint32_t capacity() const { return header ? header->capacity : 0; }
+
+        // Returns nullptr when the table is full or not open. Slots left behind
+        // by a dead process are taken over.
+        live_game_t* claim(uint64_t game_id);
+        void release(live_game_t* slot);
+        void publish(live_game_t* slot, const live_game_state_t& state);
+
+        // Consistent copy of a slot; false if it is free
+        bool read(uint32_t index, live_game_state_t& state, int32_t& owner_pid) const;
+    };
+}
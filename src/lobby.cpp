@@ -0,0 +1,201 @@
+#include "lobby.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "utils.hpp"
+
+namespace fogchess
+{
+    namespace
+    {
+        int open_listener(uint16_t port)
+        {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                perror("socket");
+                return -1;
+            }
+
+            int opt = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = INADDR_ANY;
+            address.sin_port = htons(port);
+
+            if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+                perror("bind");
+                close(fd);
+                return -1;
+            }
+
+            if (listen(fd, SOMAXCONN) < 0) {
+                perror("listen");
+                close(fd);
+                return -1;
+            }
+
+            return fd;
+        }
+
+        // A player may give up while parked, never pair them with a live one
+        bool is_connected(int fd)
+        {
+            pollfd pfd{fd, POLLRDHUP, 0};
+            if (poll(&pfd, 1, 0) < 0)
+                return true;
+            return (pfd.revents & (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)) == 0;
+        }
+    }
+
+    Lobby::Lobby(const lobby_config_t& config, std::function<void(const pairing_t&)> on_pair)
+        : config(config), on_pair(std::move(on_pair)), queue(config.queue_capacity), running(false)
+    {
+    }
+
+    Lobby::~Lobby()
+    {
+        stop();
+    }
+
+    bool Lobby::start()
+    {
+        for (std::size_t i = 0; i < config.acceptor_count; ++i) {
+            int fd = open_listener(config.port);
+            if (fd < 0) {
+                stop();
+                return false;
+            }
+            listen_fds.push_back(fd);
+        }
+
+        running = true;
+        matchmaker = std::thread(&Lobby::matchmaker_loop, this);
+        for (int fd : listen_fds)
+            acceptors.emplace_back(&Lobby::accept_loop, this, fd);
+
+        return true;
+    }
+
+    void Lobby::stop()
+    {
+        running = false;
+
+        // Unblocks the acceptors sitting in accept4()
+        for (int fd : listen_fds)
+            shutdown(fd, SHUT_RDWR);
+
+        for (auto& t : acceptors)
+            t.join();
+        acceptors.clear();
+
+        if (matchmaker.joinable())
+            matchmaker.join();
+
+        for (int fd : listen_fds)
+            close(fd);
+        listen_fds.clear();
+
+        int fd;
+        while (queue.try_pop(fd))
+            close(fd);
+    }
+
+    bool Lobby::enqueue(int client_fd)
+    {
+        return queue.try_push(client_fd);
+    }
+
+    void Lobby::accept_loop(int listen_fd)
+    {
+        auto last_warning = std::chrono::steady_clock::time_point();
+
+        while (running) {
+            int client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client_fd < 0) {
+                if (!running)
+                    break;
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+
+                // Typically out of fds or memory (EMFILE, ENFILE, ENOBUFS, ENOMEM):
+                // the connection stays pending, so retrying right away would spin.
+                // Give running games time to end and free some.
+                auto now = std::chrono::steady_clock::now();
+                if (now - last_warning >= std::chrono::seconds(1)) {
+                    perror("accept");
+                    last_warning = now;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                continue;
+            }
+
+            int opt = 1;
+            setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+            // Greet before queueing, the matchmaker may pair us right away
+            send_text(client_fd, "Waiting for an opponent...\n");
+            if (!enqueue(client_fd)) {
+                send_text(client_fd, "Lobby is full, try again later\n");
+                close(client_fd);
+            }
+        }
+    }
+
+    void Lobby::matchmaker_loop()
+    {
+        int waiting = -1;
+        std::minstd_rand rng(std::random_device{}());
+        unsigned idle_rounds = 0;
+
+        while (running) {
+            bool paired = false;
+
+            int fd;
+            while (queue.try_pop(fd)) {
+                if (waiting >= 0 && !is_connected(waiting)) {
+                    close(waiting);
+                    waiting = -1;
+                }
+
+                if (waiting < 0) {
+                    waiting = fd;
+                    continue;
+                }
+
+                bool first_is_white = rng() & 1;
+                pairing_t pairing{
+                    first_is_white ? waiting : fd,
+                    first_is_white ? fd : waiting
+                };
+                waiting = -1;
+                on_pair(pairing);
+                paired = true;
+            }
+
+            // Back off gradually so an idle lobby does not burn a core while
+            // keeping the pairing latency of a busy one under a millisecond.
+            if (paired) {
+                idle_rounds = 0;
+            } else if (++idle_rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+
+        if (waiting >= 0)
+            close(waiting);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+
+namespace fogchess
+{
+    struct pairing_t {
+        int white_fd;
+        int black_fd;
+    };
+
+    struct lobby_config_t {
+        uint16_t port = 8001;
+        std::size_t acceptor_count = 1;     // SO_REUSEPORT listeners on the same port
+        std::size_t queue_capacity = 4096;  // a full queue rejects new players
+    };
+
+    // Accepts any number of players on a single port and pairs them up.
+    // Acceptors push client sockets into a lock-free queue, a single
+    // matchmaker thread drains it two at a time and hands each pair over.
+    // Everyone shares one queue, there is no bucketing by time control or
+    // rating yet.
+    class Lobby
+    {
+    private:
+        lobby_config_t config;
+        std::function<void(const pairing_t&)> on_pair;
+
+        MpmcQueue<int> queue;
+        std::vector<int> listen_fds;
+        std::vector<std::thread> acceptors;
+        std::thread matchmaker;
+        std::atomic<bool> running;
+
+        void accept_loop(int listen_fd);
+        void matchmaker_loop();
+
+    public:
+        Lobby(const lobby_config_t& config, std::function<void(const pairing_t&)> on_pair);
+        ~Lobby();
+
+        Lobby(const Lobby&) = delete;
+        Lobby& operator=(const Lobby&) = delete;
+
+        // Binds the listeners and starts the acceptor and matchmaker threads.
+        bool start();
+        void stop();
+
+        // Queues an already connected client; returns false if the queue is full.
+        bool enqueue(int client_fd);
+    };
+}
@@ -0,0 +1,265 @@
+#include "logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "serializer.hpp"
+#include "utils.hpp"
+
+namespace fogchess
+{
+    namespace
+    {
+        const char* LEVEL_NAMES[] = {"ERROR", "INFO", "DEBUG"};
+        const char* BAD_INPUT_NAMES[] = {"format", "bad squares", "illegal move"};
+
+        uint64_t now_ns()
+        {
+            auto now = std::chrono::system_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        }
+
+        void format_record(const log_record_t& record, std::ostringstream& out)
+        {
+            out << '[' << record.timestamp_ns / 1000000000 << '.';
+            out.width(6);
+            out.fill('0');
+            out << record.timestamp_ns / 1000 % 1000000 << "] ";
+            out << LEVEL_NAMES[record.level] << " game " << record.game_id << ' ';
+
+            switch (record.event) {
+            case EVENT_GAME_START:
+                out << "started";
+                break;
+            case EVENT_MOVE:
+                out << "move " << serialize_move(record.move) << " think " << record.think_us << "us";
+                break;
+            case EVENT_BAD_INPUT:
+                out << "rejected input (" << BAD_INPUT_NAMES[record.detail] << ')';
+                break;
+            case EVENT_GAME_OVER:
+                out << "over, winner " << (record.move == 1 ? "White" : "Black")
+                    << " (" << end_reason_name(static_cast<end_reason_t>(record.detail)) << ')';
+                break;
+            }
+            out << '\n';
+
+            if (record.has_board)
+                print_real_board(unpack_board(record.board), out);
+        }
+    }
+
+    const char* end_reason_name(end_reason_t reason)
+    {
+        switch (reason) {
+        case KING_CAPTURED: return "king captured";
+        case FLAG_FALL:     return "flag fall";
+        case IDLE_TIMEOUT:  return "idle timeout";
+        case DISCONNECT:    return "disconnect";
+        case RESIGNATION:   return "resignation";
+        default:            return "unknown";
+        }
+    }
+
+    logger_config_t logger_config_from_env()
+    {
+        logger_config_t config;
+
+        if (const char* level = std::getenv("FOGCHESS_LOG_LEVEL")) {
+            if (std::strcmp(level, "error") == 0)
+                config.level = LOG_ERROR;
+            else if (std::strcmp(level, "debug") == 0)
+                config.level = LOG_DEBUG;
+            else
+                config.level = LOG_INFO;
+        }
+
+        if (const char* every = std::getenv("FOGCHESS_LOG_BOARD_EVERY"))
+            config.board_every = static_cast<uint32_t>(std::strtoul(every, nullptr, 10));
+
+        if (const char* overflow = std::getenv("FOGCHESS_LOG_OVERFLOW"))
+            config.overflow = std::strcmp(overflow, "wait") == 0 ? OVERFLOW_WAIT : OVERFLOW_DROP;
+
+        return config;
+    }
+
+    Logger::Logger()
+        : os(nullptr), has_new_producers(false), running(false)
+    {
+    }
+
+    Logger::~Logger()
+    {
+        stop();
+    }
+
+    Logger& Logger::global()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    void Logger::start(const logger_config_t& config, std::ostream& os)
+    {
+        if (running)
+            return;
+
+        this->config = config;
+        this->os = &os;
+        running = true;
+        writer = std::thread(&Logger::run, this);
+    }
+
+    void Logger::stop()
+    {
+        if (!running.exchange(false))
+            return;
+        if (writer.joinable())
+            writer.join();
+    }
+
+    Logger::producer_t& Logger::local_producer()
+    {
+        // Marks the ring closed when its thread exits so the writer can drop it
+        struct handle_t {
+            std::shared_ptr<producer_t> producer;
+            ~handle_t() { if (producer) producer->is_closed = true; }
+        };
+        thread_local handle_t handle;
+
+        if (!handle.producer) {
+            std::lock_guard<std::mutex> lock(producers_mutex);
+            if (idle_producers.empty()) {
+                handle.producer = std::make_shared<producer_t>(config.ring_capacity);
+            } else {
+                handle.producer = std::move(idle_producers.back());
+                idle_producers.pop_back();
+                handle.producer->is_closed = false;
+                handle.producer->move_count = 0;
+            }
+            new_producers.push_back(handle.producer);
+            has_new_producers = true;
+        }
+        return *handle.producer;
+    }
+
+    void Logger::log(log_level_t level, log_event_t event, uint64_t game_id, packed_move_t move,
+                     uint32_t think_us, uint8_t detail, const compact_board_t* board)
+    {
+        if (!is_enabled(level))
+            return;
+
+        log_record_t record;
+        record.timestamp_ns = now_ns();
+        record.game_id = game_id;
+        record.think_us = think_us;
+        record.move = move;
+        record.event = event;
+        record.level = level;
+        record.detail = detail;
+        record.has_board = board != nullptr;
+        if (board)
+            record.board = *board;
+
+        producer_t& producer = local_producer();
+        while (!producer.ring.try_push(record)) {
+            if (config.overflow == OVERFLOW_DROP || !running) {
+                producer.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void Logger::log_move(uint64_t game_id, packed_move_t move, uint32_t think_us, const real_board_t& board)
+    {
+        if (!is_enabled(LOG_INFO))
+            return;
+
+        producer_t& producer = local_producer();
+        bool is_sampled = config.board_every > 0 && ++producer.move_count % config.board_every == 0;
+        if (!is_sampled) {
+            log(LOG_INFO, EVENT_MOVE, game_id, move, think_us);
+            return;
+        }
+
+        compact_board_t compact = pack_board(board);
+        log(LOG_INFO, EVENT_MOVE, game_id, move, think_us, 0, &compact);
+    }
+
+    bool Logger::drain(std::ostringstream& out)
+    {
+        if (has_new_producers.exchange(false)) {
+            std::lock_guard<std::mutex> lock(producers_mutex);
+            for (auto& producer : new_producers)
+                producers.push_back(std::move(producer));
+            new_producers.clear();
+        }
+
+        bool has_output = false;
+        std::vector<std::shared_ptr<producer_t>> closed;
+        log_record_t record;
+
+        for (std::size_t i = 0; i < producers.size();) {
+            producer_t& producer = *producers[i];
+            // Read before popping: once closed, nothing more is pushed after this pass
+            bool is_closed = producer.is_closed;
+
+            while (producer.ring.try_pop(record)) {
+                format_record(record, out);
+                has_output = true;
+            }
+
+            uint64_t dropped = producer.dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                out << "logger: dropped " << dropped << " records\n";
+                has_output = true;
+            }
+
+            if (is_closed) {
+                closed.push_back(std::move(producers[i]));
+                producers[i] = std::move(producers.back());
+                producers.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        // Drained rings of exited threads go back to the pool for the next thread
+        if (!closed.empty()) {
+            std::lock_guard<std::mutex> lock(producers_mutex);
+            for (auto& producer : closed)
+                idle_producers.push_back(std::move(producer));
+        }
+
+        if (has_output) {
+            *os << out.str();
+            os->flush();
+            out.str("");
+        }
+        return has_output;
+    }
+
+    void Logger::run()
+    {
+        std::ostringstream out;
+        auto pause = std::chrono::milliseconds(1);
+
+        // Back off while there is nothing to write, rings hold bursts meanwhile
+        while (running) {
+            if (drain(out)) {
+                pause = std::chrono::milliseconds(1);
+            } else {
+                std::this_thread::sleep_for(pause);
+                pause = std::min(pause * 2, std::chrono::milliseconds(8));
+            }
+        }
+
+        // Whatever was pushed before stop() still goes out
+        drain(out);
+    }
+}
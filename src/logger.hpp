@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "compact.hpp"
+#include "spsc_ring.hpp"
+
+namespace fogchess
+{
+    enum log_level_t : uint8_t {
+        LOG_ERROR = 0,
+        LOG_INFO,
+        LOG_DEBUG,
+    };
+
+    enum log_event_t : uint8_t {
+        EVENT_GAME_START = 0,
+        EVENT_MOVE,
+        EVENT_BAD_INPUT,    // detail: bad_input_t
+        EVENT_GAME_OVER,    // detail: end_reason_t, winner in `move`: 1 white, 2 black
+    };
+
+    enum bad_input_t : uint8_t {
+        BAD_FORMAT = 0,
+        BAD_SQUARES,
+        ILLEGAL_MOVE,
+    };
+
+    enum end_reason_t : uint8_t {
+        KING_CAPTURED = 0,
+        FLAG_FALL,
+        IDLE_TIMEOUT,
+        DISCONNECT,
+        RESIGNATION,
+    };
+
+    const char* end_reason_name(end_reason_t reason);
+
+    enum overflow_policy_t : uint8_t {
+        OVERFLOW_DROP = 0,  // drop the new record and count it, never blocks
+        OVERFLOW_WAIT,      // spin until the writer catches up, for lossless audits
+    };
+
+    // Fixed size so a record is one copy into the ring, formatting happens
+    // on the logger thread.
+    struct log_record_t {
+        uint64_t timestamp_ns;
+        uint64_t game_id;
+        uint32_t think_us;
+        packed_move_t move;
+        log_event_t event;
+        log_level_t level;
+        uint8_t detail;
+        uint8_t has_board;
+        compact_board_t board;
+    };
+
+    struct logger_config_t {
+        log_level_t level = LOG_INFO;
+        uint32_t board_every = 1;       // attach the board to every Nth move, 0 for never
+        overflow_policy_t overflow = OVERFLOW_DROP;
+        std::size_t ring_capacity = 128;    // records per producing thread, 8 KiB
+    };
+
+    // Reads FOGCHESS_LOG_LEVEL (error|info|debug), FOGCHESS_LOG_BOARD_EVERY
+    // and FOGCHESS_LOG_OVERFLOW (drop|wait), keeping defaults for unset ones.
+    logger_config_t logger_config_from_env();
+
+    // Asynchronous structured logger. Every producing thread gets its own
+    // lock-free ring on first use; a background thread drains all of them,
+    // formats the records as text and writes them out in batches. Rings of
+    // exited threads are kept in a pool and handed to the next new thread.
+    class Logger
+    {
+    private:
+        struct producer_t {
+            SpscRing<log_record_t> ring;
+            std::atomic<uint64_t> dropped;
+            std::atomic<bool> is_closed;
+            uint32_t move_count;
+
+            explicit producer_t(std::size_t capacity)
+                : ring(capacity), dropped(0), is_closed(false), move_count(0) {}
+        };
+
+        logger_config_t config;
+        std::ostream* os;
+
+        // Threads register here; the writer only takes the lock to pick up new
+        // producers or hand back closed ones, never on an idle pass
+        std::mutex producers_mutex;
+        std::vector<std::shared_ptr<producer_t>> new_producers;
+        std::vector<std::shared_ptr<producer_t>> idle_producers;   // closed and drained
+        std::atomic<bool> has_new_producers;
+
+        std::vector<std::shared_ptr<producer_t>> producers;        // writer thread only
+
+        std::thread writer;
+        std::atomic<bool> running;
+
+        producer_t& local_producer();
+        bool drain(std::ostringstream& out);
+        void run();
+
+    public:
+        Logger();
+        ~Logger();
+
+        static Logger& global();
+
+        void start(const logger_config_t& config, std::ostream& os);
+        // Flushes everything already pushed before returning
+        void stop();
+
+        bool is_enabled(log_level_t level) const { return running && level <= config.level; }
+
+        // One ring push, no allocation, no lock. Only a thread's first record
+        // takes the producers lock, and allocates a ring if the pool is empty.
+        void log(log_level_t level, log_event_t event, uint64_t game_id, packed_move_t move = NO_MOVE,
+                 uint32_t think_us = 0, uint8_t detail = 0, const compact_board_t* board = nullptr);
+        // Like log() for EVENT_MOVE, attaching the board only on sampled moves
+        void log_move(uint64_t game_id, packed_move_t move, uint32_t think_us, const real_board_t& board);
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace fogchess
+{
+    // Bounded lock-free multi-producer multi-consumer queue (Vyukov).
+    // Capacity is rounded up to a power of two.
+    template <typename T>
+    class MpmcQueue
+    {
+    private:
+        struct slot_t {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        std::unique_ptr<slot_t[]> slots;
+        std::size_t mask;
+
+        alignas(CACHE_LINE) std::atomic<std::size_t> enqueue_pos;
+        alignas(CACHE_LINE) std::atomic<std::size_t> dequeue_pos;
+
+    public:
+        explicit MpmcQueue(std::size_t capacity)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            slots.reset(new slot_t[size]);
+            mask = size - 1;
+            for (std::size_t i = 0; i < size; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+
+            enqueue_pos.store(0, std::memory_order_relaxed);
+            dequeue_pos.store(0, std::memory_order_relaxed);
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        // Returns false when the queue is full.
+        bool try_push(const T& value)
+        {
+            std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                slot_t& slot = slots[pos & mask];
+                std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (diff == 0) {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Returns false when the queue is empty.
+        bool try_pop(T& value)
+        {
+            std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            for (;;) {
+                slot_t& slot = slots[pos & mask];
+                std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                if (diff == 0) {
+                    if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = slot.value;
+                        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Approximate, only meaningful while the queue is quiescent.
+        std::size_t size_approx() const
+        {
+            std::size_t head = enqueue_pos.load(std::memory_order_relaxed);
+            std::size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+            return head >= tail ? head - tail : 0;
+        }
+
+        std::size_t capacity() const { return mask + 1; }
+    };
+}
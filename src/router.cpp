@@ -0,0 +1,366 @@
+#include "router.hpp"
+
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ipc.hpp"
+#include "utils.hpp"
+
+namespace fogchess
+{
+    Router::Router(const std::string& exe_path, const lobby_config_t& lobby_config)
+        : exe_path(exe_path), lobby_config(lobby_config), next_worker_id(0), next_game_id(1)
+    {
+    }
+
+    bool Router::spawn_worker()
+    {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0) {
+            perror("socketpair");
+            return false;
+        }
+
+        // Built before fork, the child may only make async-signal-safe calls
+        std::string fd_arg = std::to_string(sv[1]);
+        sigset_t no_signals;
+        sigemptyset(&no_signals);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            close(sv[0]);
+            close(sv[1]);
+            return false;
+        }
+
+        if (pid == 0) {
+            fcntl(sv[1], F_SETFD, 0);
+            sigprocmask(SIG_SETMASK, &no_signals, nullptr);
+            execl(exe_path.c_str(), exe_path.c_str(), "--worker", fd_arg.c_str(), (char*)nullptr);
+            _exit(127);
+        }
+
+        close(sv[1]);
+
+        int worker_id = next_worker_id++;
+        workers[worker_id] = {pid, sv[0], false, 0};
+        ring.add_worker(worker_id);
+
+        std::cout << "Worker " << worker_id << " started (pid " << pid << ")\n";
+        return true;
+    }
+
+    void Router::drain_worker()
+    {
+        // Keep at least one worker serving new games
+        int active = 0;
+        int newest = -1;
+        for (const auto& [id, worker] : workers) {
+            if (!worker.is_draining) {
+                active++;
+                newest = id;
+            }
+        }
+        if (active < 2)
+            return;
+
+        worker_t& worker = workers[newest];
+        worker.is_draining = true;
+        ring.remove_worker(newest);
+
+        std::cout << "Draining worker " << newest << " (" << worker.game_count << " games)\n";
+        if (worker.game_count == 0) {
+            forget_worker(newest);
+            return;
+        }
+
+        router_message_t message{};
+        message.type = DRAIN;
+        send_message(worker.fd, message);
+    }
+
+    void Router::rebalance()
+    {
+        for (const auto& [game_id, owner] : game_owner) {
+            if (ring.worker_for(game_id) == owner)
+                continue;
+
+            router_message_t message{};
+            message.type = MIGRATE_GAME;
+            message.snapshot.game_id = game_id;
+            send_message(workers[owner].fd, message);
+        }
+    }
+
+    void Router::route(const game_snapshot_t& snapshot, int white_fd, int black_fd)
+    {
+        int fds[2] = {white_fd, black_fd};
+        router_message_t message{};
+        message.type = START_GAME;
+        message.snapshot = snapshot;
+
+        for (;;) {
+            int worker_id = ring.worker_for(snapshot.game_id);
+            if (worker_id < 0) {
+                send_text(white_fd, "No game server available, try again later\n");
+                send_text(black_fd, "No game server available, try again later\n");
+                break;
+            }
+
+            worker_t& worker = workers[worker_id];
+            if (send_message(worker.fd, message, fds, 2)) {
+                game_owner[snapshot.game_id] = worker_id;
+                worker.game_count++;
+                break;
+            }
+
+            forget_worker(worker_id);
+        }
+
+        // The worker holds its own copies now
+        close(white_fd);
+        close(black_fd);
+    }
+
+    void Router::forget_worker(int worker_id)
+    {
+        auto it = workers.find(worker_id);
+        if (it == workers.end())
+            return;
+
+        ring.remove_worker(worker_id);
+        close(it->second.fd);
+
+        for (auto game = game_owner.begin(); game != game_owner.end();) {
+            if (game->second == worker_id)
+                game = game_owner.erase(game);
+            else
+                ++game;
+        }
+
+        workers.erase(it);
+    }
+
+    void Router::handle_message(int worker_id)
+    {
+        worker_t& worker = workers[worker_id];
+
+        router_message_t message;
+        int fds[2];
+        int fd_count;
+        if (!recv_message(worker.fd, message, fds, fd_count)) {
+            std::cout << "Worker " << worker_id << " exited\n";
+            for (int i = 0; i < fd_count; ++i)
+                close(fds[i]);
+            forget_worker(worker_id);
+            return;
+        }
+
+        if (message.type == GAME_ENDED || message.type == GAME_EXPORTED) {
+            game_owner.erase(message.snapshot.game_id);
+            if (worker.game_count > 0)
+                worker.game_count--;
+        }
+
+        if (message.type == GAME_EXPORTED) {
+            if (fd_count == 2) {
+                route(message.snapshot, fds[0], fds[1]);
+            } else {
+                for (int i = 0; i < fd_count; ++i)
+                    close(fds[i]);
+            }
+        }
+
+        // A drained worker exits once it sees the socket close
+        auto it = workers.find(worker_id);
+        if (it != workers.end() && it->second.is_draining && it->second.game_count == 0) {
+            std::cout << "Worker " << worker_id << " drained\n";
+            forget_worker(worker_id);
+        }
+    }
+
+    int Router::run(std::size_t worker_count)
+    {
+        // Blocked before any thread starts so only the signalfd sees them
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        sigaddset(&signals, SIGUSR2);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &signals, nullptr);
+        int signal_fd = signalfd(-1, &signals, SFD_CLOEXEC);
+        if (signal_fd < 0) {
+            perror("signalfd");
+            return EXIT_FAILURE;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t i = 0; i < worker_count; ++i)
+                spawn_worker();
+        }
+
+        Lobby lobby(lobby_config, [this](const pairing_t& pairing) {
+            game_snapshot_t snapshot{};
+            snapshot.game_id = next_game_id++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            route(snapshot, pairing.white_fd, pairing.black_fd);
+        });
+
+        if (!lobby.start()) {
+            std::cerr << "Failed to start the lobby on port " << lobby_config.port << "\n";
+            return EXIT_FAILURE;
+        }
+
+        bool running = true;
+        while (running) {
+            std::vector<pollfd> fds{{signal_fd, POLLIN, 0}};
+            std::vector<int> ids;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& [id, worker] : workers) {
+                    fds.push_back({worker.fd, POLLIN, 0});
+                    ids.push_back(id);
+                }
+            }
+
+            if (poll(fds.data(), fds.size(), -1) < 0)
+                continue;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (fds[0].revents) {
+                signalfd_siginfo info;
+                if (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+                    switch (info.ssi_signo) {
+                    case SIGUSR1:
+                        if (spawn_worker())
+                            rebalance();
+                        break;
+                    case SIGUSR2:
+                        drain_worker();
+                        break;
+                    case SIGCHLD:
+                        while (waitpid(-1, nullptr, WNOHANG) > 0) {}
+                        break;
+                    default:
+                        running = false;
+                        break;
+                    }
+                }
+            }
+
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents && workers.count(ids[i - 1]))
+                    handle_message(ids[i - 1]);
+            }
+        }
+
+        lobby.stop();
+
+        // Workers finish the games they have and exit on their own
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!workers.empty())
+            forget_worker(workers.begin()->first);
+        close(signal_fd);
+
+        return EXIT_SUCCESS;
+    }
+
+    int run_worker(int router_fd, const session_config_t& config)
+    {
+        TimingWheel wheel(std::chrono::milliseconds(10));
+        wheel.start();
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::unordered_map<uint64_t, std::shared_ptr<GameControl>> games;
+        bool is_draining = false;
+
+        router_message_t message;
+        int fds[2];
+        int fd_count;
+        while (recv_message(router_fd, message, fds, fd_count)) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            switch (message.type) {
+            case START_GAME: {
+                if (fd_count != 2) {
+                    for (int i = 0; i < fd_count; ++i)
+                        close(fds[i]);
+                    break;
+                }
+
+                auto control = std::make_shared<GameControl>();
+                if (is_draining)
+                    control->request_migration();
+                games[message.snapshot.game_id] = control;
+
+                bool is_started = start_game_thread(fds[0], fds[1], config,
+                                                    [&, control, snapshot = message.snapshot, white_fd = fds[0], black_fd = fds[1]]() mutable {
+                    router_message_t reply{};
+                    reply.snapshot = snapshot;
+
+                    if (play_game(white_fd, black_fd, config, wheel, reply.snapshot, control.get())) {
+                        reply.type = GAME_ENDED;
+                        send_message(router_fd, reply);
+                    } else {
+                        int client_fds[2] = {white_fd, black_fd};
+                        reply.type = GAME_EXPORTED;
+                        send_message(router_fd, reply, client_fds, 2);
+                        close(white_fd);
+                        close(black_fd);
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    games.erase(snapshot.game_id);
+                    idle.notify_all();
+                });
+
+                // The players are gone, let the router forget the game
+                if (!is_started) {
+                    games.erase(message.snapshot.game_id);
+                    router_message_t reply{};
+                    reply.type = GAME_ENDED;
+                    reply.snapshot = message.snapshot;
+                    send_message(router_fd, reply);
+                }
+                break;
+            }
+            case MIGRATE_GAME: {
+                auto it = games.find(message.snapshot.game_id);
+                if (it != games.end())
+                    it->second->request_migration();
+                break;
+            }
+            case DRAIN:
+                is_draining = true;
+                for (auto& [game_id, control] : games)
+                    control->request_migration();
+                break;
+            default:
+                break;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [&] { return games.empty(); });
+        close(router_fd);
+
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hash_ring.hpp"
+#include "lobby.hpp"
+#include "session.hpp"
+
+namespace fogchess
+{
+    // Front end of the multi-process server. Runs the lobby, gives every pair
+    // a game ID and passes both client sockets to the worker process that owns
+    // that ID on the hash ring. Workers are re-executions of this binary
+    // talking to the router over a Unix socket pair.
+    //
+    // SIGUSR1 starts one more worker and migrates the games that now hash to
+    // it, SIGUSR2 drains the newest worker by migrating all of its games away.
+    class Router
+    {
+    private:
+        struct worker_t {
+            pid_t pid;
+            int fd;
+            bool is_draining;
+            std::size_t game_count;
+        };
+
+        std::string exe_path;
+        lobby_config_t lobby_config;
+
+        std::mutex mutex;
+        HashRing ring;
+        std::map<int, worker_t> workers;
+        std::unordered_map<uint64_t, int> game_owner;
+        int next_worker_id;
+        std::atomic<uint64_t> next_game_id;
+
+        bool spawn_worker();
+        void drain_worker();
+        void rebalance();
+        void route(const game_snapshot_t& snapshot, int white_fd, int black_fd);
+        void forget_worker(int worker_id);
+        void handle_message(int worker_id);
+
+    public:
+        Router(const std::string& exe_path, const lobby_config_t& lobby_config);
+
+        // Blocks until SIGINT or SIGTERM
+        int run(std::size_t worker_count);
+    };
+
+    // Worker side: runs every game the router hands over on its own thread
+    // until the router closes the socket and the last game is over.
+    int run_worker(int router_fd, const session_config_t& config);
+}
@@ -1,5 +1,6 @@
 #include "serializer.hpp"
 
+#include <cstdio>
 #include <sstream>
 
 namespace fogchess
@@ -72,4 +73,24 @@ namespace fogchess
         return board;
     }
 
-}
\ No newline at end of file
+    std::string serialize_move(packed_move_t packed)
+    {
+        if (packed == NO_MOVE)
+            return "-";
+
+        move_t move = unpack_move(packed);
+        std::string s;
+        s += char('a' + move.start_cell.cell_id % 8);
+        s += char('1' + move.start_cell.cell_id / 8);
+        s += char('a' + move.end_cell.cell_id % 8);
+        s += char('1' + move.end_cell.cell_id / 8);
+        return s;
+    }
+
+    std::string format_clock(int64_t ms)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%lld:%02lld.%lld", (long long)(ms / 60000), (long long)(ms / 1000 % 60), (long long)(ms / 100 % 10));
+        return buf;
+    }
+}
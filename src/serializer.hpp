@@ -3,6 +3,7 @@
 #include <string>
 
 #include "common.hpp"
+#include "compact.hpp"
 
 namespace fogchess
 {
@@ -11,4 +12,9 @@ namespace fogchess
 
     std::string serialize_board(const player_board_t& board);
     player_board_t deserialize_board(const std::string& board_str);
+
+    // Coordinate notation such as "e2e4", "-" for NO_MOVE
+    std::string serialize_move(packed_move_t move);
+    // Clock time as m:ss.t
+    std::string format_clock(int64_t ms);
 }
\ No newline at end of file
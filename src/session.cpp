@@ -0,0 +1,318 @@
+#include "session.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "compact_gamestate.hpp"
+#include "gamestate.hpp"
+#include "live_table.hpp"
+#include "logger.hpp"
+#include "serializer.hpp"
+#include "utils.hpp"
+
+namespace fogchess
+{
+    namespace
+    {
+#ifdef FOGCHESS_COMPACT_GAMES
+        using session_game_t = CompactGameState;
+#else
+        using session_game_t = GameState;
+#endif
+
+        std::string prompt_for(const session_game_t& game, const GameClock* clock, bool is_player_white)
+        {
+            const player_board_t& player_board = is_player_white ? game.get_white_player() : game.get_black_player();
+            std::string prompt = (is_player_white ? "White" : "Black") + std::string(" to move\n") + serialize_board(player_board) + "\n";
+            if (clock)
+                prompt += "Clock: White " + format_clock(clock->remaining(true)) + " | Black " + format_clock(clock->remaining(false)) + "\n";
+            return prompt + "Enter move (e.g., e2e4) or 'q': ";
+        }
+
+        void publish_live(LiveTable& live, live_game_t* slot, const session_game_t& game, const GameClock* clock,
+                          const game_snapshot_t& snapshot)
+        {
+            if (!slot)
+                return;
+
+            live_game_state_t state;
+            state.game_id = slot->state.game_id;
+            state.board = pack_board(game.get_board());
+            state.white_visible = game.get_visibility_mask(true);
+            state.black_visible = game.get_visibility_mask(false);
+            state.clock_ms[0] = clock ? clock->remaining(true) : 0;
+            state.clock_ms[1] = clock ? clock->remaining(false) : 0;
+            state.move_count = snapshot.move_count;
+            state.last_move_latency_us = snapshot.last_move_latency_us;
+            state.last_move = snapshot.last_move;
+            state.is_white_turn = game.is_white_turn();
+            state.winner = game.has_winner() ? (game.get_winner_raw() == 1 ? 1 : 2) : 0;
+            live.publish(slot, state);
+        }
+    }
+
+    namespace
+    {
+        std::atomic<std::size_t> running_games{0};
+    }
+
+    bool start_game_thread(int white_fd, int black_fd, const session_config_t& config, std::function<void()> game)
+    {
+        if (running_games.fetch_add(1) < config.max_games) {
+            try {
+                std::thread([game = std::move(game)]() {
+                    game();
+                    running_games--;
+                }).detach();
+                return true;
+            } catch (const std::exception&) {
+                // Out of threads or address space, the running games carry on
+            }
+        }
+        running_games--;
+
+        send_text(white_fd, "Server is busy, try again later\n");
+        send_text(black_fd, "Server is busy, try again later\n");
+        close(white_fd);
+        close(black_fd);
+        return false;
+    }
+
+    GameControl::GameControl()
+        : wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), migration_requested(false)
+    {
+    }
+
+    GameControl::~GameControl()
+    {
+        if (wake_fd >= 0)
+            close(wake_fd);
+    }
+
+    void GameControl::wake()
+    {
+        uint64_t one = 1;
+        ssize_t n = write(wake_fd, &one, sizeof(one));
+        (void)n;
+    }
+
+    void GameControl::clear()
+    {
+        uint64_t value;
+        ssize_t n = read(wake_fd, &value, sizeof(value));
+        (void)n;
+    }
+
+    void GameControl::request_migration()
+    {
+        migration_requested = true;
+        wake();
+    }
+
+    bool play_game(int white_fd, int black_fd, const session_config_t& config, TimingWheel& wheel,
+                   game_snapshot_t& snapshot, GameControl* control)
+    {
+        GameControl local_control;
+        if (!control)
+            control = &local_control;
+
+        // Initialize GameState
+        std::string start_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        session_game_t game = snapshot.has_position
+            ? session_game_t(unpack_board(snapshot.board), snapshot.is_white_turn)
+            : session_game_t(start_fen);
+
+        bool is_timed = config.time_control.initial_ms > 0;
+        GameClock clock(config.time_control);
+        if (snapshot.has_position) {
+            clock.set_remaining(true, snapshot.remaining_ms[0]);
+            clock.set_remaining(false, snapshot.remaining_ms[1]);
+        }
+        const GameClock* shown_clock = is_timed ? &clock : nullptr;
+        bool is_turn_started = false;
+        auto turn_started_at = std::chrono::steady_clock::now();
+        end_reason_t reason = KING_CAPTURED;
+        Logger& log = Logger::global();
+
+        wheel_timer_t timer;
+        std::atomic<bool> timed_out{false};
+
+        if (!snapshot.has_position) {
+            snapshot.last_move = NO_MOVE;
+            snapshot.last_move_latency_us = 0;
+            log.log(LOG_INFO, EVENT_GAME_START, snapshot.game_id);
+        }
+
+        // Monitoring gets a copy of every move, the table itself is never read here
+        LiveTable& live = LiveTable::global();
+        live_game_t* live_slot = live.claim(snapshot.game_id);
+        publish_live(live, live_slot, game, shown_clock, snapshot);
+
+        if (snapshot.has_position) {
+            send_text(white_fd, "Game resumed\n");
+            send_text(black_fd, "Game resumed\n");
+        } else {
+            send_text(white_fd, "Opponent found, you play White\n");
+            send_text(black_fd, "Opponent found, you play Black\n");
+        }
+
+        while (true) {
+            bool is_player_white = game.is_white_turn();
+            int client_fd = is_player_white ? white_fd : black_fd;
+            int opponent_fd = is_player_white ? black_fd : white_fd;
+
+            auto now = std::chrono::steady_clock::now();
+            if (!is_turn_started) {
+                clock.start_turn(is_player_white, now);
+                turn_started_at = now;
+                is_turn_started = true;
+            }
+
+            send_text(client_fd, prompt_for(game, shown_clock, is_player_white));
+
+            // Counted from the start of the turn, rejected input does not buy more time
+            auto idle_left = std::max(std::chrono::milliseconds(0),
+                                      config.idle_timeout - std::chrono::duration_cast<std::chrono::milliseconds>(now - turn_started_at));
+            auto deadline = is_timed ? std::min(clock.time_left(now), idle_left) : idle_left;
+            wheel.schedule(timer, deadline, [&timed_out, control]() {
+                timed_out = true;
+                control->wake();
+            });
+
+            // Wait for input, the opponent hanging up, a timeout or a migration
+            // request, whichever comes first
+            bool is_readable = false;
+            bool is_opponent_gone = false;
+            while (!timed_out && !control->is_migration_requested()) {
+                pollfd fds[3] = {{client_fd, POLLIN, 0}, {opponent_fd, POLLRDHUP, 0}, {control->fd(), POLLIN, 0}};
+                if (poll(fds, 3, -1) < 0)
+                    continue;
+                if (fds[2].revents)
+                    control->clear();
+                if (fds[0].revents) {
+                    is_readable = true;
+                    break;
+                }
+                if (fds[1].revents) {
+                    is_opponent_gone = true;
+                    break;
+                }
+            }
+            wheel.cancel(timer);
+            now = std::chrono::steady_clock::now();
+
+            if (!is_readable && !timed_out && !is_opponent_gone) {
+                // Hand the game over mid-turn: charge the time spent so far and stop here
+                clock.suspend(now);
+                snapshot.has_position = 1;
+                snapshot.is_white_turn = game.is_white_turn();
+                snapshot.board = pack_board(game.get_board());
+                snapshot.remaining_ms[0] = clock.remaining(true);
+                snapshot.remaining_ms[1] = clock.remaining(false);
+                live.release(live_slot);
+                send_text(white_fd, "Game is moving to another server, hold on...\n");
+                send_text(black_fd, "Game is moving to another server, hold on...\n");
+                return false;
+            }
+
+            // --- Socket input ---
+            char buf[16] = {0};
+            ssize_t n = (timed_out || is_opponent_gone) ? 0 : recv(client_fd, buf, sizeof(buf)-1, 0);
+
+            if (timed_out) {
+                reason = (is_timed && clock.time_left(now).count() == 0) ? FLAG_FALL : IDLE_TIMEOUT;
+                game.declare_winner(!is_player_white);
+            } else if (is_opponent_gone) {
+                reason = DISCONNECT;
+                game.declare_winner(is_player_white);
+            } else if (n <= 0) {
+                reason = DISCONNECT;
+                game.declare_winner(!is_player_white);
+            }
+
+            if (!game.has_winner()) {
+                std::string s(buf);
+                s.erase(std::remove(s.begin(), s.end(), '\n'), s.end());
+                s.erase(std::remove(s.begin(), s.end(), '\r'), s.end());
+                if (s == "q" || s == "quit") {
+                    reason = RESIGNATION;
+                    game.declare_winner(!is_player_white);
+                } else if (s.size() != 4) {
+                    std::string msg = "Format: e2e4\n";
+                    log.log(LOG_DEBUG, EVENT_BAD_INPUT, snapshot.game_id, NO_MOVE, 0, BAD_FORMAT);
+                    send_text(client_fd, msg);
+                    continue;
+                } else {
+                    // Convert input to move_t
+                    std::string from_str = s.substr(0, 2);
+                    std::string to_str = s.substr(2, 2);
+                    std::pair<uint8_t, uint8_t> from_rf = {from_str[1] - '1', from_str[0] - 'a'};
+                    std::pair<uint8_t, uint8_t> to_rf = {to_str[1] - '1', to_str[0] - 'a'};
+                    if (!is_valid(from_rf) || !is_valid(to_rf)) {
+                        std::string msg = "Bad squares\n";
+                        log.log(LOG_DEBUG, EVENT_BAD_INPUT, snapshot.game_id, NO_MOVE, 0, BAD_SQUARES);
+                        send_text(client_fd, msg);
+                        continue;
+                    }
+                    cell_t from_cell{static_cast<int>(from_rf.first * 8 + from_rf.second)};
+                    cell_t to_cell{static_cast<int>(to_rf.first * 8 + to_rf.second)};
+                    move_t move{from_cell, to_cell};
+
+                    // Validate move legality using GameState
+                    if (!game.is_valid_move(move)) {
+                        std::string msg = "Illegal move\n";
+                        log.log(LOG_DEBUG, EVENT_BAD_INPUT, snapshot.game_id, pack_move(move), 0, ILLEGAL_MOVE);
+                        send_text(client_fd, msg);
+                        continue;
+                    }
+
+                    // A move that arrives after the flag fell between two ticks still loses
+                    if (is_timed && !clock.end_turn(now)) {
+                        reason = FLAG_FALL;
+                        game.declare_winner(!is_player_white);
+                    } else {
+                        // Apply move
+                        game.make_move(move);
+                        is_turn_started = false;
+
+                        auto think_us = std::chrono::duration_cast<std::chrono::microseconds>(now - turn_started_at).count();
+                        log.log_move(snapshot.game_id, pack_move(move), static_cast<uint32_t>(think_us), game.get_board());
+
+                        // After move, send updated board to both players
+                        send_text(white_fd, prompt_for(game, shown_clock, true));
+                        send_text(black_fd, prompt_for(game, shown_clock, false));
+
+                        snapshot.move_count++;
+                        snapshot.last_move = pack_move(move);
+                        auto latency = std::chrono::steady_clock::now() - now;
+                        snapshot.last_move_latency_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+                        publish_live(live, live_slot, game, shown_clock, snapshot);
+                    }
+                }
+            }
+
+            // Check for winner
+            if (game.has_winner()) {
+                std::string msg = "Game over! Winner: ";
+                msg += (game.get_winner_raw() == 1 ? "White" : "Black");
+                msg += std::string(" (") + end_reason_name(reason) + ")\n";
+                log.log(LOG_INFO, EVENT_GAME_OVER, snapshot.game_id, game.get_winner_raw() == 1 ? 1 : 2, 0, reason);
+                publish_live(live, live_slot, game, shown_clock, snapshot);
+                send_text(white_fd, msg);
+                send_text(black_fd, msg);
+                break;
+            }
+        }
+
+        live.release(live_slot);
+        close(white_fd);
+        close(black_fd);
+        return true;
+    }
+}
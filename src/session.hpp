@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "compact.hpp"
+#include "game_clock.hpp"
+#include "timing_wheel.hpp"
+
+namespace fogchess
+{
+    struct session_config_t {
+        time_control_t time_control;            // initial_ms == 0 plays without a clock
+        std::chrono::milliseconds idle_timeout; // longest the side to move may stay silent
+        std::size_t max_games = 4096;           // game threads per process, more are turned away
+    };
+
+    // Everything needed to pick a game up again, possibly in another process
+    struct game_snapshot_t {
+        uint64_t game_id;
+        uint8_t has_position;   // 0 for a game that has not started yet
+        uint8_t is_white_turn;
+        compact_board_t board;
+        int64_t remaining_ms[2];
+        uint32_t move_count;
+        uint32_t last_move_latency_us;
+        packed_move_t last_move;    // NO_MOVE before the first move
+    };
+
+    // Lets other threads interrupt a running game, e.g. to migrate it.
+    // Wraps an eventfd the game polls next to the socket of the side to move.
+    class GameControl
+    {
+    private:
+        int wake_fd;
+        std::atomic<bool> migration_requested;
+
+    public:
+        GameControl();
+        ~GameControl();
+
+        GameControl(const GameControl&) = delete;
+        GameControl& operator=(const GameControl&) = delete;
+
+        void wake();
+        void clear();
+        int fd() const { return wake_fd; }
+
+        void request_migration();
+        bool is_migration_requested() const { return migration_requested; }
+    };
+
+    // Runs a game between two connected clients. Blocks the calling thread
+    // until the game is over and closes both sockets, or until a migration is
+    // requested through `control`; then the sockets stay open, `snapshot`
+    // holds the position and false is returned.
+    //
+    // A snapshot with has_position set resumes that game instead of starting
+    // a new one. The shared wheel enforces clocks and idle timeouts.
+    bool play_game(int white_fd, int black_fd, const session_config_t& config, TimingWheel& wheel,
+                   game_snapshot_t& snapshot, GameControl* control = nullptr);
+
+    // Runs `game` on a detached thread of its own. When config.max_games games
+    // are already running or no thread can be created, both players are told
+    // the server is busy, their sockets are closed and false is returned.
+    bool start_game_thread(int white_fd, int black_fd, const session_config_t& config, std::function<void()> game);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace fogchess
+{
+    // Bounded lock-free single-producer single-consumer ring.
+    // Capacity is rounded up to a power of two.
+    template <typename T>
+    class SpscRing
+    {
+    private:
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        std::unique_ptr<T[]> slots;
+        std::size_t mask;
+
+        // Each side keeps a stale copy of the other's index and only reloads
+        // it when the ring looks full (or empty), saving cache line transfers.
+        alignas(CACHE_LINE) std::atomic<std::size_t> head;
+        std::size_t cached_tail;
+        alignas(CACHE_LINE) std::atomic<std::size_t> tail;
+        std::size_t cached_head;
+
+    public:
+        explicit SpscRing(std::size_t capacity)
+            : head(0), cached_tail(0), tail(0), cached_head(0)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            slots.reset(new T[size]);
+            mask = size - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        // Producer side, returns false when the ring is full.
+        bool try_push(const T& value)
+        {
+            std::size_t h = head.load(std::memory_order_relaxed);
+            if (h - cached_tail > mask) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (h - cached_tail > mask)
+                    return false;
+            }
+
+            slots[h & mask] = value;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side, returns false when the ring is empty.
+        bool try_pop(T& value)
+        {
+            std::size_t t = tail.load(std::memory_order_relaxed);
+            if (t == cached_head) {
+                cached_head = head.load(std::memory_order_acquire);
+                if (t == cached_head)
+                    return false;
+            }
+
+            value = slots[t & mask];
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const
+        {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+    };
+}
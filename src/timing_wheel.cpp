@@ -0,0 +1,149 @@
+#include "timing_wheel.hpp"
+
+namespace fogchess
+{
+    TimingWheel::TimingWheel(std::chrono::milliseconds tick_length)
+        : current_tick(0), tick_length(tick_length), running(false)
+    {
+        for (auto& level : wheel)
+            level.fill(nullptr);
+    }
+
+    TimingWheel::~TimingWheel()
+    {
+        stop();
+    }
+
+    void TimingWheel::start()
+    {
+        if (running.exchange(true))
+            return;
+        ticker = std::thread(&TimingWheel::run, this);
+    }
+
+    void TimingWheel::stop()
+    {
+        running = false;
+        if (ticker.joinable())
+            ticker.join();
+    }
+
+    void TimingWheel::link(wheel_timer_t& timer)
+    {
+        uint64_t delta = timer.expires - current_tick;
+
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS)))
+            level++;
+
+        timer.level = static_cast<uint8_t>(level);
+        timer.slot = static_cast<uint8_t>((timer.expires >> (level * SLOT_BITS)) & SLOT_MASK);
+
+        wheel_timer_t*& head = wheel[timer.level][timer.slot];
+        timer.prev = nullptr;
+        timer.next = head;
+        if (head)
+            head->prev = &timer;
+        head = &timer;
+        timer.armed = true;
+    }
+
+    void TimingWheel::unlink(wheel_timer_t& timer)
+    {
+        if (timer.prev)
+            timer.prev->next = timer.next;
+        else
+            wheel[timer.level][timer.slot] = timer.next;
+
+        if (timer.next)
+            timer.next->prev = timer.prev;
+
+        timer.prev = timer.next = nullptr;
+        timer.armed = false;
+    }
+
+    void TimingWheel::schedule(wheel_timer_t& timer, std::chrono::milliseconds delay, std::function<void()> callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (timer.armed)
+            unlink(timer);
+
+        // One extra tick covers the part of the current tick that already passed
+        uint64_t ticks = 1;
+        if (delay.count() > 0)
+            ticks += (delay.count() + tick_length.count() - 1) / tick_length.count();
+        if (ticks > MAX_TICKS)
+            ticks = MAX_TICKS;
+
+        timer.expires = current_tick + ticks;
+        timer.callback = std::move(callback);
+        link(timer);
+    }
+
+    bool TimingWheel::cancel(wheel_timer_t& timer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!timer.armed)
+            return false;
+        unlink(timer);
+        return true;
+    }
+
+    void TimingWheel::cascade(int level)
+    {
+        auto slot = (current_tick >> (level * SLOT_BITS)) & SLOT_MASK;
+
+        wheel_timer_t* timer = wheel[level][slot];
+        wheel[level][slot] = nullptr;
+
+        while (timer) {
+            wheel_timer_t* next = timer->next;
+            link(*timer);
+            timer = next;
+        }
+
+        if (slot == 0 && level + 1 < LEVELS)
+            cascade(level + 1);
+    }
+
+    void TimingWheel::tick()
+    {
+        current_tick++;
+
+        if ((current_tick & SLOT_MASK) == 0)
+            cascade(1);
+
+        auto slot = current_tick & SLOT_MASK;
+        while (wheel_timer_t* timer = wheel[0][slot]) {
+            unlink(*timer);
+            timer->callback();
+        }
+    }
+
+    void TimingWheel::advance(uint64_t ticks)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (ticks-- > 0)
+            tick();
+    }
+
+    void TimingWheel::run()
+    {
+        auto next = std::chrono::steady_clock::now() + tick_length;
+
+        while (running) {
+            std::this_thread::sleep_until(next);
+
+            // Catch up on ticks lost to a late wakeup instead of drifting
+            uint64_t ticks = 0;
+            auto now = std::chrono::steady_clock::now();
+            while (next <= now) {
+                next += tick_length;
+                ticks++;
+            }
+            advance(ticks);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace fogchess
+{
+    // Intrusive timer node, owned by whoever schedules it. It must stay alive
+    // until it fires or cancel() returns.
+    struct wheel_timer_t {
+        wheel_timer_t* prev = nullptr;
+        wheel_timer_t* next = nullptr;
+        uint64_t expires = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool armed = false;
+        std::function<void()> callback;
+    };
+
+    // Hierarchical timing wheel: 4 levels of 64 slots. Scheduling and
+    // cancelling are O(1), each tick touches a single slot plus an occasional
+    // cascade, independent of how many timers are armed.
+    //
+    // Callbacks run on the wheel thread with the wheel locked, so they must be
+    // short and must not call back into the wheel. In exchange, once cancel()
+    // returns the callback is guaranteed not to be running.
+    class TimingWheel
+    {
+    private:
+        static constexpr int LEVELS = 4;
+        static constexpr int SLOT_BITS = 6;
+        static constexpr int SLOTS = 1 << SLOT_BITS;
+        static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+        static constexpr uint64_t MAX_TICKS = (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1;
+
+        std::array<std::array<wheel_timer_t*, SLOTS>, LEVELS> wheel;
+        uint64_t current_tick;
+        std::chrono::milliseconds tick_length;
+
+        std::mutex mutex;
+        std::thread ticker;
+        std::atomic<bool> running;
+
+        void link(wheel_timer_t& timer);
+        void unlink(wheel_timer_t& timer);
+        void cascade(int level);
+        void tick();
+        void run();
+
+    public:
+        explicit TimingWheel(std::chrono::milliseconds tick_length = std::chrono::milliseconds(10));
+        ~TimingWheel();
+
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+
+        void start();
+        void stop();
+
+        // (Re)arms the timer to fire no earlier than `delay` from now.
+        void schedule(wheel_timer_t& timer, std::chrono::milliseconds delay, std::function<void()> callback);
+        // Returns true if the timer was still pending.
+        bool cancel(wheel_timer_t& timer);
+
+        // Moves time forward by hand, used by the ticker thread.
+        void advance(uint64_t ticks);
+    };
+}
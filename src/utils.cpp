@@ -1,9 +1,12 @@
 #include "utils.hpp"
 
+#include "serializer.hpp"
+
 #include <cctype>
 #include <iostream>
 #include <string>
 #include <set>
+#include <sys/socket.h>
 
 namespace fogchess
 {
@@ -83,45 +86,148 @@ namespace fogchess
 
     void print_real_board(const real_board_t& board, std::ostream& os)
     {
-        const std::map<uint8_t, char> piece_to_char = {
-            {PAWN | WHITE, 'P'}, {PAWN | BLACK, 'p'},
-            {ROOK | WHITE, 'R'}, {ROOK | BLACK, 'r'},
-            {KNIGHT | WHITE, 'N'}, {KNIGHT | BLACK, 'n'},
-            {BISHOP | WHITE, 'B'}, {BISHOP | BLACK, 'b'},
-            {QUEEN | WHITE, 'Q'}, {QUEEN | BLACK, 'q'},
-            {KING | WHITE, 'K'}, {KING | BLACK, 'k'}
-        };
+        char line[9];
+        line[8] = '\n';
 
         for (int rank = 7; rank >= 0; --rank) {
             for (int file = 0; file < 8; ++file) {
                 cell_t cell{ rank * 8 + file };
-                piece_t piece = get_piece_at_cell(board, cell);
-                os << (piece != EMPTY ? piece_to_char.at(piece) : '.');
+                line[file] = *piece_to_char(get_piece_at_cell(board, cell));
             }
-            os << '\n';
+            os.write(line, sizeof(line));
         }
     }
 
-    player_board_t board_for_player(const real_board_t& board, bool is_player_white) {
-        player_board_t player_board;
-        player_board.board.fill(UNKNOWN);
+    void send_text(int fd, const std::string& msg)
+    {
+        send(fd, msg.c_str(), msg.size(), MSG_NOSIGNAL);
+    }
 
+    uint64_t visibility_mask(const real_board_t& board, bool is_player_white)
+    {
         piece_t color = is_player_white ? WHITE : BLACK;
-        std::set<cell_t> visible_cells;
+        uint64_t mask = 0;
 
         for (int cell_id = 0; cell_id < 64; ++cell_id) {
             piece_t piece = board.board[cell_id];
             if (piece & color) {
-                player_board.board[cell_id] = piece;
+                mask |= uint64_t(1) << cell_id;
 
                 auto moves = get_move(board, {cell_id});
                 for (auto move : moves) {
-                    player_board.board[move.end_cell.cell_id] = get_piece_at_cell(board, move.end_cell);
+                    mask |= uint64_t(1) << move.end_cell.cell_id;
                 }
             }
         }
 
-        return std::move(player_board);
+        return mask;
+    }
+
+    player_board_t board_from_mask(const real_board_t& board, uint64_t mask)
+    {
+        player_board_t player_board;
+
+        for (int cell_id = 0; cell_id < 64; ++cell_id) {
+            player_board.board[cell_id] = (mask >> cell_id) & 1 ? board.board[cell_id] : UNKNOWN;
+        }
+
+        return player_board;
+    }
+
+    player_board_t board_for_player(const real_board_t& board, bool is_player_white) {
+        return board_from_mask(board, visibility_mask(board, is_player_white));
+    }
+
+    bool is_valid_move_for(const real_board_t& board, bool is_player_white, const move_t& move)
+    {
+        auto from = move.start_cell;
+        auto to = move.end_cell;
+
+        if (!is_valid(get_rank_and_file_from_cell(from)))
+            return false;
+
+        if (!is_valid(get_rank_and_file_from_cell(to)))
+            return false;
+
+        // Own pieces are always visible, so the real board answers for the player's view
+        auto piece = get_piece_at_cell(board, from);
+        auto color = is_player_white ? WHITE : BLACK;
+
+        if (piece == EMPTY || (piece & PIECE_COLOR_MASK) != color)
+            return false;
+
+        auto moves = get_move(board, from);
+        for (auto move : moves) {
+            if (move.end_cell.cell_id == to.cell_id)
+                return true;
+        }
+
+        return false;
+    }
+
+    piece_t apply_move(real_board_t& board, const move_t& move)
+    {
+        auto piece_moved = board.board[move.start_cell.cell_id];
+
+        if (piece_moved & KING) {
+            if (piece_moved & WHITE) {
+                board.info.white_king_moved = 1;
+            } else {
+                board.info.black_king_moved = 1;
+            }
+
+            auto [rank0, file0] = get_rank_and_file_from_cell(move.start_cell);
+            auto [rank1, file1] = get_rank_and_file_from_cell(move.end_cell);
+
+            if (rank0 == 0 && rank1 == 0 && std::abs(file1 - file0) == 2) {
+                // Castling move
+                if (file1 == 6) {
+                    // Kingside castling
+                    board.board[5] = board.board[7];
+                    board.board[7] = EMPTY;
+                    board.info.white_kingside_rook_moved = 1;
+                } else if (file1 == 2) {
+                    // Queenside castling
+                    board.board[3] = board.board[0];
+                    board.board[0] = EMPTY;
+                    board.info.white_queenside_rook_moved = 1;
+                }
+            }
+
+            if (rank0 == 7 && rank1 == 7 && std::abs(file1 - file0) == 2) {
+                // Castling move
+                if (file1 == 6) {
+                    // Kingside castling
+                    board.board[61] = board.board[63];
+                    board.board[63] = EMPTY;
+                    board.info.black_kingside_rook_moved = 1;
+                } else if (file1 == 2) {
+                    // Queenside castling
+                    board.board[59] = board.board[56];
+                    board.board[56] = EMPTY;
+                    board.info.black_queenside_rook_moved = 1;
+                }
+            }
+        }
+
+
+        if (piece_moved & ROOK) {
+            if (move.start_cell.cell_id == 63)
+                board.info.white_kingside_rook_moved = 1;
+            else if (move.start_cell.cell_id == 56)
+                board.info.white_queenside_rook_moved = 1;
+            else if (move.start_cell.cell_id == 7)
+                board.info.white_kingside_rook_moved = 1;
+            else if (move.start_cell.cell_id == 0)
+                board.info.white_queenside_rook_moved = 1;
+        }
+
+        auto captured_piece = board.board[move.end_cell.cell_id];
+
+        board.board[move.end_cell.cell_id] = board.board[move.start_cell.cell_id];
+        board.board[move.start_cell.cell_id] = EMPTY;
+
+        return captured_piece;
     }
 
     std::vector<move_t> get_move(const real_board_t& board, cell_t location)
@@ -16,8 +16,16 @@ namespace fogchess {
     real_board_t board_from_fen(const std::string& fen_notation);
     void print_real_board(const real_board_t& board, std::ostream& os);
 
+    // Best effort write to a player's socket, never raises SIGPIPE
+    void send_text(int fd, const std::string& msg);
+
+    uint64_t visibility_mask(const real_board_t& board, bool is_player_white);
+    player_board_t board_from_mask(const real_board_t& board, uint64_t mask);
     player_board_t board_for_player(const real_board_t& board, bool is_player_white);
 
+    bool is_valid_move_for(const real_board_t& board, bool is_player_white, const move_t& move);
+    piece_t apply_move(real_board_t& board, const move_t& move);
+
     std::vector<move_t> get_move(const real_board_t& board, cell_t location);
 
     std::vector<move_t> melee_move(const real_board_t& board, cell_t location, const std::vector<std::pair<int, int>>& directions);
@@ -0,0 +1,99 @@
+// Reader for the shared-memory table of live games published by fogchess.
+//
+//   ./fogchess-live             dump every live game once
+//   ./fogchess-live --watch     redraw every second
+//   ./fogchess-live --boards    include the real board of each game
+
+#include <bitset>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <signal.h>
+
+#include "live_table.hpp"
+#include "serializer.hpp"
+#include "utils.hpp"
+
+using namespace fogchess;
+
+namespace
+{
+    void dump(const LiveTable& table, bool show_boards, std::ostream& os)
+    {
+        char line[160];
+        snprintf(line, sizeof(line), "%10s %7s %6s %6s %9s %9s %6s %9s %7s\n",
+                 "GAME", "PID", "TURN", "MOVES", "WHITE", "BLACK", "LAST", "LAT(us)", "VIS W/B");
+        os << line;
+
+        live_game_state_t state;
+        int32_t owner_pid;
+        uint32_t live_games = 0;
+
+        for (uint32_t i = 0; i < table.capacity(); ++i) {
+            if (!table.read(i, state, owner_pid))
+                continue;
+            // Left behind by a server process that died without releasing it
+            if (kill(owner_pid, 0) < 0 && errno == ESRCH)
+                continue;
+            live_games++;
+
+            const char* turn = state.winner == 1 ? "1-0" : state.winner == 2 ? "0-1" : state.is_white_turn ? "white" : "black";
+            std::string visible = std::to_string(std::bitset<64>(state.white_visible).count()) + "/"
+                                + std::to_string(std::bitset<64>(state.black_visible).count());
+
+            snprintf(line, sizeof(line), "%10llu %7d %6s %6u %9s %9s %6s %9u %7s\n",
+                     (unsigned long long)state.game_id, owner_pid, turn, state.move_count,
+                     format_clock(state.clock_ms[0]).c_str(), format_clock(state.clock_ms[1]).c_str(),
+                     serialize_move(state.last_move).c_str(), state.last_move_latency_us, visible.c_str());
+            os << line;
+
+            if (show_boards) {
+                print_real_board(unpack_board(state.board), os);
+                os << '\n';
+            }
+        }
+
+        os << live_games << " live games, " << table.capacity() << " slots\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool is_watching = false;
+    bool show_boards = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--watch") == 0) {
+            is_watching = true;
+        } else if (std::strcmp(argv[i], "--boards") == 0) {
+            show_boards = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--watch] [--boards]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    LiveTable table;
+    if (!table.open(LIVE_TABLE_NAME, false)) {
+        std::cerr << "No live game table at " << LIVE_TABLE_NAME << ", is the server running?\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!is_watching) {
+        dump(table, show_boards, std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    while (true) {
+        std::ostringstream frame;
+        frame << "\033[H\033[2J";
+        dump(table, show_boards, frame);
+        std::cout << frame.str() << std::flush;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}